@@ -0,0 +1,145 @@
+// Standalone monitor for a running WindowPain: maps the scheduler's shared-memory status
+// page read-only and prints a snapshot every interval. Reading never blocks the scheduler,
+// so any number of these can poll at any rate.
+//
+// Usage: StatusReader [interval-ms] [count] [page]     (count 0 polls until interrupted)
+//
+// page is the name WindowPain printed as its Status Page; it defaults to statusPageName,
+// which a second emulator on the host cannot take and publishes under a name with its
+// process ID instead.
+
+#include "../WindowPain/StatusPage.h"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static const char* stateNames[] = { "New", "Ready", "Running", "Finished", "Blocked" };
+
+// Maps the page read-only, or returns null if the scheduler has not created it
+static const StatusPage* mapStatusPage(const char* name) {
+#ifdef _WIN32
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name);
+    if (!mapping) return nullptr;
+
+    void* memory = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, sizeof(StatusPage));
+    CloseHandle(mapping);   // the view keeps the mapping alive
+    return static_cast<const StatusPage*>(memory);
+#else
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return nullptr;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(StatusPage))) {
+        close(fd);
+        return nullptr;
+    }
+    void* memory = mmap(nullptr, sizeof(StatusPage), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    return memory == MAP_FAILED ? nullptr : static_cast<const StatusPage*>(memory);
+#endif
+}
+
+static void unmapStatusPage(const StatusPage* page) {
+#ifdef _WIN32
+    UnmapViewOfFile(page);
+#else
+    munmap(const_cast<StatusPage*>(page), sizeof(StatusPage));
+#endif
+}
+
+static void printSnapshot(const StatusSnapshot& s, double instructionsPerSecond) {
+    std::cout << "---------------------------------------\n";
+    std::cout << "Tick: " << s.tick << " (" << s.tickMs << " ms)  Policy: " << s.policy
+        << "  Active Cores: " << s.activeCores << " / " << s.numCores << "\n";
+    std::cout << "Instructions: " << s.instructions << " (" << std::fixed << std::setprecision(0)
+        << instructionsPerSecond << "/s)  Dispatches: " << s.dispatches
+        << "  Migrations: " << s.migrations << "  Queue Locks: " << s.queueLocks << "\n";
+    std::cout << "Ready: " << s.ready << "  Running: " << s.running << "  Blocked: " << s.blocked
+        << "  Finished: " << s.finished << "  Waiting for Memory: " << s.waitingForMemory
+        << "  Live: " << s.live << "  Pending Admission: " << s.pendingAdmission << "\n\n";
+
+    std::cout << std::setw(6) << std::left << "Core" << std::setw(7) << "State" << std::setw(12) << "Busy Ticks"
+        << std::setw(12) << "Idle Ticks" << std::setw(10) << "Wakeups" << std::setw(12) << "Mig In/Out" << "Process\n";
+    for (int i = 0; i < s.numCores && i < statusMaxCores; ++i) {
+        const StatusCore& core = s.cores[i];
+        std::cout << std::setw(6) << i << std::setw(7) << (core.busy ? "busy" : "idle")
+            << std::setw(12) << core.busyTicks << std::setw(12) << core.idleTicks << std::setw(10) << core.wakeups
+            << std::setw(12) << (std::to_string(core.migrationsIn) + "/" + std::to_string(core.migrationsOut))
+            << core.process << "\n";
+    }
+
+    if (s.topCount > 0) {
+        std::cout << "\n" << std::setw(20) << "Process" << std::setw(10) << "State" << std::setw(6) << "Core" << "Progress\n";
+        for (int i = 0; i < s.topCount && i < statusTopProcesses; ++i) {
+            const StatusProcess& p = s.top[i];
+            bool known = p.state >= 0 && p.state < 5;
+            std::cout << std::setw(20) << p.name << std::setw(10) << (known ? stateNames[p.state] : "?")
+                << std::setw(6) << (p.state == 2 ? std::to_string(p.coreId) : "-")
+                << p.currentLine << " / " << p.totalLines << "\n";
+        }
+    }
+    std::cout << "---------------------------------------\n\n";
+    std::cout.unsetf(std::ios::fixed);
+}
+
+int main(int argc, char* argv[]) {
+    int intervalMs = argc > 1 ? std::atoi(argv[1]) : 1000;
+    long long count = argc > 2 ? std::atoll(argv[2]) : 0;
+    const char* name = argc > 3 ? argv[3] : statusPageName;
+    if (intervalMs <= 0) intervalMs = 1000;
+
+    const StatusPage* page = mapStatusPage(name);
+    if (!page) {
+        std::cerr << "No status page at " << name << ". Is WindowPain initialized with status-page-ticks > 0?\n";
+        return 1;
+    }
+    if (page->magic != statusPageMagic || page->version != statusPageVersion || page->size != sizeof(StatusPage)) {
+        std::cerr << "Status page has an unknown layout (version " << page->version
+            << ", this reader expects " << statusPageVersion << ").\n";
+        unmapStatusPage(page);
+        return 1;
+    }
+
+    StatusSnapshot snapshot;
+    long long lastInstructions = -1;
+    auto lastRead = std::chrono::steady_clock::now();
+
+    for (long long polled = 0; count == 0 || polled < count; ++polled) {
+        if (polled > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+        }
+        if (page->magic != statusPageMagic) {
+            std::cerr << "The scheduler closed the status page.\n";
+            break;
+        }
+        if (!readStatusPage(*page, snapshot)) {
+            std::cerr << "Status page busy, skipping this poll.\n";
+            continue;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(now - lastRead).count();
+        double rate = lastInstructions >= 0 && seconds > 0 ? (snapshot.instructions - lastInstructions) / seconds : 0.0;
+        lastInstructions = snapshot.instructions;
+        lastRead = now;
+        printSnapshot(snapshot, rate);
+    }
+
+    unmapStatusPage(page);
+    return 0;
+}
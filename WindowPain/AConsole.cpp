@@ -21,7 +21,7 @@ void AConsole::handleCommand(const String& input) {
         iss >> option;
 
         if (command == "screen") {
-            if (option == "-s" || option == "-r") {
+            if (option == "-s" || option == "-s-batch" || option == "-r" || option == "-ls") {
                 std::getline(iss >> std::ws, args);
                 // check args
                 if (args.empty()) {
@@ -44,7 +44,15 @@ void AConsole::handleCommand(const String& input) {
             }
         }
         else {
-            printInColor("Unknown command. Type 'help' for available commands.\n\n", "red");
+            // check second command map for commands that take arguments
+            auto it = commandMapWithArgs.find(command);
+            if (it != commandMapWithArgs.end()) {
+                std::getline(iss >> std::ws, args);
+                it->second(option + (args.empty() ? "" : " " + args));
+            }
+            else {
+                printInColor("Unknown command. Type 'help' for available commands.\n\n", "red");
+            }
         }
     }
 }
@@ -0,0 +1,194 @@
+#include "AdmissionControl.h"
+#include "Screen.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <iomanip>
+
+using std::max;
+
+AdmissionControl::AdmissionControl(const Config& config, std::function<size_t()> readyCount)
+    : maxReady(config.max_ready), maxLive(config.max_live), policy(AdmissionPolicy::Block), readyCount(std::move(readyCount)) {
+    parsePolicy(config.admission_policy, policy);
+}
+
+bool AdmissionControl::parsePolicy(const String& value, AdmissionPolicy& policy) {
+    if (value == "block") policy = AdmissionPolicy::Block;
+    else if (value == "drop") policy = AdmissionPolicy::Drop;
+    else if (value == "defer") policy = AdmissionPolicy::Defer;
+    else return false;
+    return true;
+}
+
+// Caller holds admissionMutex
+bool AdmissionControl::hasRoomLocked(size_t ready) const {
+    return (maxLive <= 0 || live < maxLive) &&
+        (maxReady <= 0 || ready < static_cast<size_t>(maxReady));
+}
+
+// Caller holds admissionMutex
+void AdmissionControl::admitLocked(Screen& screen) {
+    screen.admitted = true;
+    live++;
+    admitted++;
+}
+
+// Caller holds admissionMutex
+void AdmissionControl::recordWaitLocked(long long waitedNs) {
+    waited++;
+    totalWaitNs += waitedNs;
+    maxWaitNs = max(maxWaitNs, waitedNs);
+}
+
+// Caller holds admissionMutex. Admitted processes only reach the ready queue after the
+// lock is dropped, so they are counted against max-ready here.
+void AdmissionControl::drainLocked(ScratchVector<Screen*>& admittedNow) {
+    if (pending.empty()) return;
+
+    size_t ready = readyCount();
+    while (!pending.empty() && hasRoomLocked(ready + admittedNow.size())) {
+        Pending next = pending.front();
+        pending.pop_front();
+        admitLocked(*next.screen);
+        recordWaitLocked(elapsedNs(next.since));
+        admittedNow.push_back(next.screen);
+    }
+}
+
+// Pending processes go first, so a blocked creator waits until the pending queue is empty.
+// A creator blocks only while its canWait flag stays set; once cleared (followed by
+// wakeCreators) its process is deferred instead.
+Admission AdmissionControl::submit(Screen& screen, const std::atomic<bool>* canWait) {
+    std::unique_lock<ProfiledMutex> lock(admissionMutex);
+    if (pending.empty() && (!limited() || hasRoomLocked(readyCount()))) {
+        admitLocked(screen);
+        return Admission::Admitted;
+    }
+
+    if (policy == AdmissionPolicy::Drop) {
+        dropped++;
+        return Admission::Dropped;
+    }
+
+    if (policy == AdmissionPolicy::Block && canWait) {
+        auto start = std::chrono::steady_clock::now();
+        space.wait(lock, [&]() {
+            return !*canWait || (pending.empty() && hasRoomLocked(readyCount()));
+        });
+        if (*canWait) {
+            blocked++;
+            admitLocked(screen);
+            recordWaitLocked(elapsedNs(start));
+            return Admission::Admitted;
+        }
+    }
+
+    deferred++;
+    pending.push_back({ &screen, std::chrono::steady_clock::now() });
+    peakPending = max(peakPending, pending.size());
+    return Admission::Deferred;
+}
+
+// Admits the front of a batch under one lock while the limits allow. As for a submit
+// that cannot wait, the rest is dropped under the drop policy and deferred otherwise.
+Admission AdmissionControl::submitBatch(Screen* const* screens, size_t count, size_t& admittedCount) {
+    std::lock_guard<ProfiledMutex> lock(admissionMutex);
+    admittedCount = 0;
+    if (pending.empty()) {
+        size_t ready = limited() ? readyCount() : 0;
+        while (admittedCount < count && (!limited() || hasRoomLocked(ready + admittedCount))) {
+            admitLocked(*screens[admittedCount++]);
+        }
+    }
+    if (admittedCount == count) return Admission::Admitted;
+
+    size_t rest = count - admittedCount;
+    if (policy == AdmissionPolicy::Drop) {
+        dropped += static_cast<long long>(rest);
+        return Admission::Dropped;
+    }
+
+    deferred += static_cast<long long>(rest);
+    auto now = std::chrono::steady_clock::now();
+    for (size_t i = admittedCount; i < count; ++i) {
+        pending.push_back({ screens[i], now });
+    }
+    peakPending = max(peakPending, pending.size());
+    return Admission::Deferred;
+}
+
+void AdmissionControl::enter(Screen& screen) {
+    std::lock_guard<ProfiledMutex> lock(admissionMutex);
+    admitLocked(screen);
+}
+
+void AdmissionControl::leave(Screen& screen, ScratchVector<Screen*>& admittedNow) {
+    {
+        std::lock_guard<ProfiledMutex> lock(admissionMutex);
+        if (!screen.admitted) return;
+        screen.admitted = false;
+        live--;
+        drainLocked(admittedNow);
+    }
+    space.notify_all();
+}
+
+void AdmissionControl::poll(ScratchVector<Screen*>& admittedNow) {
+    {
+        std::lock_guard<ProfiledMutex> lock(admissionMutex);
+        drainLocked(admittedNow);
+    }
+    space.notify_all();
+}
+
+// Takes a process out of the pending queue. Returns false if it was admitted, in which
+// case it has been handed to the scheduler.
+bool AdmissionControl::withdraw(Screen& screen) {
+    std::lock_guard<ProfiledMutex> lock(admissionMutex);
+    for (auto it = pending.begin(); it != pending.end(); ++it) {
+        if (it->screen == &screen) {
+            pending.erase(it);
+            return true;
+        }
+    }
+    return !screen.admitted;
+}
+
+// Notifying under the lock means a creator that has not yet seen its flag cleared is
+// already waiting, so the wakeup is not lost
+void AdmissionControl::wakeCreators() {
+    std::lock_guard<ProfiledMutex> lock(admissionMutex);
+    space.notify_all();
+}
+
+long long AdmissionControl::liveCount() const {
+    std::lock_guard<ProfiledMutex> lock(admissionMutex);
+    return live;
+}
+
+size_t AdmissionControl::pendingCount() const {
+    std::lock_guard<ProfiledMutex> lock(admissionMutex);
+    return pending.size();
+}
+
+void AdmissionControl::printStats(std::ostream& out) const {
+    static const char* policyNames[] = { "block", "drop", "defer" };
+
+    std::lock_guard<ProfiledMutex> lock(admissionMutex);
+    out << "\n---------------------------------------\n";
+    out << "Policy: " << policyNames[static_cast<int>(policy)] << "\n";
+    out << "Max Ready: " << (maxReady > 0 ? std::to_string(maxReady) : "unlimited") << "\n";
+    out << "Max Live: " << (maxLive > 0 ? std::to_string(maxLive) : "unlimited") << "\n";
+    out << "Live Now: " << live << "\n";
+    out << "Ready Now: " << readyCount() << "\n";
+    out << "Pending Now: " << pending.size() << " (peak " << peakPending << ")\n";
+    out << "Admitted: " << admitted << "\n";
+    out << "Blocked Creator: " << blocked << "\n";
+    out << "Deferred: " << deferred << "\n";
+    out << "Rejected (dropped): " << dropped << "\n";
+    out << std::fixed << std::setprecision(3);
+    out << "Admission Wait: " << (waited > 0 ? totalWaitNs / 1e6 / waited : 0.0) << " ms avg, "
+        << maxWaitNs / 1e6 << " ms max\n";
+    out << std::defaultfloat;
+    out << "---------------------------------------\n\n";
+}
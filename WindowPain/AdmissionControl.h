@@ -0,0 +1,73 @@
+#ifndef ADMISSIONCONTROL_H
+#define ADMISSIONCONTROL_H
+
+#include "Config.h"
+#include "Utils.h"
+#include "Arena.h"
+#include "Profiler.h"
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <vector>
+#include <functional>
+#include <atomic>
+#include <ostream>
+
+class Screen;
+
+enum class AdmissionPolicy { Block, Drop, Defer };
+enum class Admission { Admitted, Deferred, Dropped };
+
+// Backpressure on process creation. A process is admitted while fewer than max-live
+// processes are unfinished and fewer than max-ready wait in the ready queue; otherwise
+// the creator blocks, the process is dropped, or it waits in the pending queue until a
+// process finishes or the ready queue drains. Limits of 0 are unlimited.
+class AdmissionControl {
+private:
+    struct Pending {
+        Screen* screen;
+        std::chrono::steady_clock::time_point since;
+    };
+
+    int maxReady;
+    int maxLive;
+    AdmissionPolicy policy;
+    std::function<size_t()> readyCount;         // processes in the ready queue
+    std::deque<Pending> pending;                // deferred processes, in arrival order
+    mutable ProfiledMutex admissionMutex{ LockSite::Admission };
+    std::condition_variable_any space;              // blocked creators wait here
+    long long live = 0;                         // admitted and not finished
+
+    long long admitted = 0;
+    long long blocked = 0;                      // admissions that blocked the creator
+    long long deferred = 0;
+    long long dropped = 0;
+    long long waited = 0;                       // admissions after blocking or pending
+    long long totalWaitNs = 0;
+    long long maxWaitNs = 0;
+    size_t peakPending = 0;
+
+    bool hasRoomLocked(size_t ready) const;
+    void admitLocked(Screen& screen);
+    void recordWaitLocked(long long waitedNs);
+    void drainLocked(ScratchVector<Screen*>& admittedNow);
+
+public:
+    AdmissionControl(const Config& config, std::function<size_t()> readyCount);
+    bool limited() const { return maxReady > 0 || maxLive > 0; }
+    Admission submit(Screen& screen, const std::atomic<bool>* canWait);  // null: defer instead of blocking
+    Admission submitBatch(Screen* const* screens, size_t count, size_t& admittedCount);  // never blocks; outcome of the rest
+    void enter(Screen& screen);                         // admit regardless of the limits
+    void leave(Screen& screen, ScratchVector<Screen*>& admittedNow);  // free the process's slot; admit pending ones
+    void poll(ScratchVector<Screen*>& admittedNow);       // admit pending ones the ready queue has room for
+    bool withdraw(Screen& screen);                      // false if the process holds an admission
+    void wakeCreators();                                // recheck canWait of blocked creators
+    long long liveCount() const;
+    size_t pendingCount() const;
+    void printStats(std::ostream& out) const;
+
+    static bool parsePolicy(const String& value, AdmissionPolicy& policy);
+};
+
+#endif // ADMISSIONCONTROL_H
@@ -0,0 +1,34 @@
+#include "AllocStats.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global operator new so allocation counts can be read at run time
+static std::atomic<long long> allocationCount{ 0 };
+static thread_local long long threadAllocations = 0;
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    threadAllocations++;
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+long long heapAllocationCount() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+long long threadAllocationCount() {
+    return threadAllocations;
+}
@@ -0,0 +1,10 @@
+#ifndef ALLOCSTATS_H
+#define ALLOCSTATS_H
+
+// Heap allocations made through operator new since start-up, across all threads
+long long heapAllocationCount();
+
+// Heap allocations made by the calling thread since it started
+long long threadAllocationCount();
+
+#endif // ALLOCSTATS_H
@@ -0,0 +1,50 @@
+#include "Arena.h"
+
+#include <new>
+#include <algorithm>
+
+static size_t alignUp(size_t value) {
+    const size_t align = alignof(std::max_align_t);
+    return (value + align - 1) / align * align;
+}
+
+Arena::~Arena() {
+    for (Chunk& chunk : chunks) {
+        ::operator delete(chunk.memory);
+    }
+}
+
+// Carves from the current chunk, moving on to the next kept chunk that is large enough
+// and allocating a new one only when none is
+void* Arena::allocate(size_t bytes) {
+    bytes = alignUp(std::max<size_t>(bytes, 1));
+    while (current < chunks.size() && offset + bytes > chunks[current].size) {
+        current++;
+        offset = 0;
+    }
+    if (current == chunks.size()) {
+        size_t size = std::max(chunkBytes, bytes);
+        chunks.push_back({ static_cast<char*>(::operator new(size)), size });
+        offset = 0;
+    }
+
+    void* memory = chunks[current].memory + offset;
+    offset += bytes;
+    return memory;
+}
+
+void Arena::rewind(const Mark& to) {
+    current = to.chunk;
+    offset = to.offset;
+}
+
+size_t Arena::reservedBytes() const {
+    size_t total = 0;
+    for (const Chunk& chunk : chunks) total += chunk.size;
+    return total;
+}
+
+Arena& Arena::local() {
+    static thread_local Arena arena;
+    return arena;
+}
@@ -0,0 +1,80 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <vector>
+#include <cstddef>
+
+// Bump allocator for short-lived scratch memory. Every thread has its own (local()), so
+// allocation takes no lock; an ArenaScope hands everything allocated inside it back at
+// once. Chunks are kept for reuse, so a thread whose scratch needs have peaked no longer
+// touches the heap.
+class Arena {
+private:
+    struct Chunk {
+        char* memory;
+        size_t size;
+    };
+
+    static const size_t chunkBytes = 65536;
+
+    std::vector<Chunk> chunks;
+    size_t current = 0;     // chunk being carved
+    size_t offset = 0;      // first free byte in it
+
+public:
+    struct Mark {
+        size_t chunk;
+        size_t offset;
+    };
+
+    Arena() = default;
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t bytes);
+    Mark mark() const { return { current, offset }; }
+    void rewind(const Mark& to);        // free everything allocated since mark
+    size_t reservedBytes() const;
+
+    static Arena& local();              // the calling thread's arena
+};
+
+// Frees the calling thread's scratch allocations when it goes out of scope. Scopes nest.
+class ArenaScope {
+private:
+    Arena& arena;
+    Arena::Mark start;
+
+public:
+    ArenaScope() : arena(Arena::local()), start(arena.mark()) {}
+    ~ArenaScope() { arena.rewind(start); }
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+};
+
+// Standard allocator over the calling thread's arena. Freeing is left to the enclosing
+// ArenaScope, so a container using it must not outlive that scope or leave its thread.
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    ArenaAllocator() = default;
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(Arena::local().allocate(n * sizeof(T))); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>&) const { return false; }
+};
+
+// Scratch list on the calling thread's arena
+template <typename T>
+using ScratchVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif // ARENA_H
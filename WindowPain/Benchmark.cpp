@@ -0,0 +1,608 @@
+#include "Benchmark.h"
+#include "ReadyQueue.h"
+#include "NameTable.h"
+#include "LogCache.h"
+#include "AllocStats.h"
+#include "Screen.h"
+#include "SchedulerPolicy.h"
+#include "InstructionBlock.h"
+#include "ProcessIndex.h"
+#include "Arena.h"
+#include "Scheduler.h"
+#include "Config.h"
+#include "Utils.h"
+
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include <map>
+#include <queue>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <string>
+#include <sstream>
+
+static const int coreCounts[] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+
+// Runs body(threadIndex) on the given number of threads released together and
+// returns the elapsed wall time in seconds
+static double timeThreads(int threads, const std::function<void(int)>& body) {
+    std::atomic<bool> go{ false };
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t]() {
+            while (!go) std::this_thread::yield();
+            body(t);
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go = true;
+    for (auto& thread : pool) thread.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// The ready queue as it was before ReadyQueue: std::queue, one mutex and a shared condition variable
+class MutexCvQueue {
+private:
+    std::queue<Screen*> screenQueue;
+    std::mutex queueMutex;
+    std::condition_variable cv;
+public:
+    void push(Screen* screen) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            screenQueue.push(screen);
+        }
+        cv.notify_one();
+    }
+    Screen* pop() {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        cv.wait(lock, [this] { return !screenQueue.empty(); });
+        Screen* screen = screenQueue.front();
+        screenQueue.pop();
+        return screen;
+    }
+};
+
+// Each core requeues a process and takes the next one, like a worker after every quantum
+void benchmarkReadyQueue(std::ostream& out) {
+    const int totalOps = 400000;
+
+    out << "\nReady queue throughput (million enqueue+dequeue pairs per second)\n";
+    out << std::setw(8) << std::left << "Cores" << std::setw(14) << "mutex+cv" << std::setw(14) << "locked" << "ring\n";
+
+    for (int threads : coreCounts) {
+        int opsPerThread = totalOps / threads;
+        double pairs = static_cast<double>(opsPerThread) * threads;
+
+        MutexCvQueue baseline;
+        double baselineTime = timeThreads(threads, [&](int t) {
+            Screen* screen = reinterpret_cast<Screen*>(static_cast<uintptr_t>(t + 1));
+            for (int i = 0; i < opsPerThread; ++i) {
+                baseline.push(screen);
+                screen = baseline.pop();
+            }
+        });
+
+        auto runQueue = [&](ReadyQueue& queue) {
+            return timeThreads(threads, [&](int t) {
+                Screen* screen = reinterpret_cast<Screen*>(static_cast<uintptr_t>(t + 1));
+                for (int i = 0; i < opsPerThread; ++i) {
+                    while (!queue.push(screen)) std::this_thread::yield();
+                    while (!queue.tryPop(screen)) std::this_thread::yield();
+                }
+            });
+        };
+
+        LockedReadyQueue locked;
+        double lockedTime = runQueue(locked);
+        RingReadyQueue ring(1024);
+        double ringTime = runQueue(ring);
+
+        out << std::setw(8) << std::left << threads << std::fixed << std::setprecision(2)
+            << std::setw(14) << pairs / baselineTime / 1e6
+            << std::setw(14) << pairs / lockedTime / 1e6
+            << pairs / ringTime / 1e6 << "\n";
+        out.unsetf(std::ios::fixed);
+    }
+    out << "\n";
+}
+
+// Dispatches processes round robin and writes a quantum of log lines each time, first the
+// way the scheduler used to (fresh path string and ofstream per dispatch, name formatted per
+// line), then through interned names and the shared log handle cache
+void benchmarkLogPath(std::ostream& out) {
+    const int processes = 64;
+    const int dispatches = 20000;
+    const int linesPerDispatch = 5;
+    const char* timestamp = "(01/01/2024 12:00:00 AM)";
+
+    std::vector<String> processNames;
+    for (int i = 0; i < processes; ++i) {
+        processNames.push_back("bench-log-" + std::to_string(i));
+    }
+
+    long long allocationsBefore = heapAllocationCount();
+    auto start = std::chrono::steady_clock::now();
+    for (int d = 0; d < dispatches; ++d) {
+        const String& name = processNames[d % processes];
+        std::ofstream logFile(name + ".txt", std::ios::app);
+        for (int line = 0; line < linesPerDispatch; ++line) {
+            logFile << timestamp << " Core:" << 0 << " \"Hello world from " << name << "!\"\n";
+            logFile.flush();
+        }
+    }
+    double oldTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long long oldAllocations = heapAllocationCount() - allocationsBefore;
+
+    NameTable names;
+    std::vector<const NameEntry*> entries;
+    for (const auto& name : processNames) {
+        entries.push_back(&names.intern(name));
+    }
+    LogCache cache(processes);
+
+    allocationsBefore = heapAllocationCount();
+    start = std::chrono::steady_clock::now();
+    for (int d = 0; d < dispatches; ++d) {
+        const NameEntry& entry = *entries[d % processes];
+        FILE* logFile = cache.acquire(entry, false);
+        for (int line = 0; line < linesPerDispatch && logFile; ++line) {
+            fprintf(logFile, "%s Core:%d %s", timestamp, 0, entry.message.c_str());
+        }
+        cache.release(entry.pid);
+    }
+    double newTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long long newAllocations = heapAllocationCount() - allocationsBefore;
+
+    cache.closeAll();
+    for (const auto& name : processNames) {
+        std::remove((name + ".txt").c_str());
+    }
+
+    out << "\nLog path: " << dispatches << " dispatches of " << linesPerDispatch << " lines over " << processes << " processes\n";
+    out << std::setw(22) << std::left << "" << std::setw(16) << "Allocations" << std::setw(18) << "Allocs/dispatch" << "Time (s)\n";
+    out << std::setw(22) << "ofstream per dispatch" << std::setw(16) << oldAllocations
+        << std::setw(18) << static_cast<double>(oldAllocations) / dispatches << oldTime << "\n";
+    out << std::setw(22) << "interned + cache" << std::setw(16) << newAllocations
+        << std::setw(18) << static_cast<double>(newAllocations) / dispatches << newTime << "\n";
+    out << "Handle cache hits: " << cache.hitCount() << ", misses: " << cache.missCount() << "\n\n";
+}
+
+// Cores run quantum-cycles 1 processes through a locked ready queue the way Scheduler::worker
+// does: take a batch, round-robin it locally while the queue is empty, return leftovers together
+void benchmarkDispatchBatch(std::ostream& out) {
+    const int threads = 8;
+    const int processes = 256;
+    const int instructions = 200;
+    const int batchSizes[] = { 1, 2, 4, 8, 16, 32 };
+
+    NameTable names;
+    const NameEntry& entry = names.intern("bench-batch");
+
+    out << "\nDispatch batching: " << threads << " cores, " << processes << " processes of "
+        << instructions << " instructions, quantum-cycles 1\n";
+    out << std::setw(8) << std::left << "Batch" << std::setw(14) << "Locks" << std::setw(18) << "Locks/instr" << "Instr/s (M)\n";
+
+    for (int batch : batchSizes) {
+        std::vector<Screen> screens(processes, Screen(entry, instructions));
+        LockedReadyQueue queue;
+        for (auto& screen : screens) {
+            queue.push(&screen);
+        }
+        long long locksBefore = queue.lockCount();
+        std::atomic<int> finishedCount{ 0 };
+        std::atomic<long long> executed{ 0 };
+
+        double elapsed = timeThreads(threads, [&](int) {
+            std::vector<Screen*> localRun(batch);
+            size_t localCount = 0;
+            long long work = 0;
+
+            while (finishedCount < processes) {
+                if (localCount == 0) {
+                    localCount = queue.popBatch(localRun.data(), batch, threads);
+                    if (localCount == 0) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                }
+
+                do {
+                    size_t kept = 0;
+                    for (size_t i = 0; i < localCount; ++i) {
+                        Screen* screen = localRun[i];
+                        screen->currentLine++;      // one instruction per quantum
+                        work++;
+                        if (screen->currentLine < screen->totalLines) localRun[kept++] = screen;
+                        else finishedCount++;
+                    }
+                    localCount = kept;
+                } while (localCount > 0 && queue.size() == 0);
+
+                localCount -= queue.pushBatch(localRun.data(), localCount);
+            }
+            executed += work;
+        });
+
+        long long locks = queue.lockCount() - locksBefore;
+        out << std::setw(8) << batch << std::setw(14) << locks
+            << std::setw(18) << static_cast<double>(locks) / executed
+            << executed / elapsed / 1e6 << "\n";
+    }
+    out << "\n";
+}
+
+// One core runs processes through the real scheduler of each policy, with no execution
+// delay and no process logs, so what is timed is dispatch, the instruction loop and
+// requeueing as PolicyScheduler<Policy> compiles them
+void benchmarkDispatchPolicy(std::ostream& out) {
+    const int processes = 1024;
+    const int instructions = 1000;
+    const int rounds = 3;
+    const char* const policies[] = { "fcfs", "rr", "cfs" };
+
+    NameTable names;
+    std::vector<const NameEntry*> entries;
+    for (int i = 0; i < processes; ++i) {
+        entries.push_back(&names.intern("bench-policy-" + std::to_string(i)));
+    }
+
+    Config bench;
+    bench.num_cpu = 1;
+    bench.quantum_cycles = 1;
+    bench.tick_ms = 1;
+    bench.delays_per_exec = 0;
+    bench.status_page_ticks = 0;
+    bench.process_logs = false;
+
+    out << "\nDispatch path: " << processes << " processes of " << instructions
+        << " instructions on 1 core, no delay, no logs, tick 1 ms, best of " << rounds << "\n";
+    out << std::setw(8) << std::left << "Policy" << std::setw(12) << "Dispatches" << std::setw(12) << "Time (ms)"
+        << std::setw(12) << "ns/disp" << "Instr/s (M)\n";
+
+    for (const char* policy : policies) {
+        bench.scheduler = policy;
+        double best = 0;
+        long long dispatches = 0;
+        for (int round = 0; round < rounds; ++round) {
+            std::vector<Screen> screens;
+            screens.reserve(processes);
+            for (const NameEntry* entry : entries) screens.emplace_back(*entry, instructions);
+
+            std::unique_ptr<Scheduler> scheduler = Scheduler::create(bench);
+            for (auto& screen : screens) scheduler->getIndex().add(screen);
+            scheduler->start();
+
+            auto start = std::chrono::steady_clock::now();
+            for (auto& screen : screens) scheduler->addProcess(screen);
+            while (scheduler->getIndex().count(ProcessState::Finished) < static_cast<size_t>(processes)) {
+                std::this_thread::yield();
+            }
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            std::unique_ptr<StatusSnapshot> status(new StatusSnapshot);
+            scheduler->collectStatus(*status, scheduler->currentTick());
+            scheduler->stop();
+            if (round == 0 || elapsed < best) {
+                best = elapsed;
+                dispatches = status->dispatches;
+            }
+        }
+        out << std::setw(8) << policy << std::setw(12) << dispatches << std::setw(12) << best * 1e3
+            << std::setw(12) << best * 1e9 / std::max(1LL, dispatches)
+            << static_cast<double>(processes) * instructions / best / 1e6 << "\n";
+    }
+    out << "\n";
+}
+
+// Reads a whole file for comparing the outputs of the two instruction paths
+static String readFile(const String& path) {
+    std::ifstream file(path, std::ios::binary);
+    return String(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// One core runs processes with no execution delay, first one instruction at a time (timestamp
+// formatted and record printed per line), then as fused blocks up to the quantum boundary
+void benchmarkInstructionPath(std::ostream& out) {
+    const int processes = 16;
+    const int instructions = 20000;
+    const int quantum = 5000;
+
+    NameTable names;
+    std::vector<const NameEntry*> entries;
+    for (int i = 0; i < processes; ++i) {
+        entries.push_back(&names.intern("bench-ins-" + std::to_string(i)));
+    }
+    LogCache cache(processes);
+
+    auto run = [&](bool fused) {
+        std::vector<int> progress(processes, 0);
+        TimestampCache clock;
+        InstructionBlock block;
+        auto start = std::chrono::steady_clock::now();
+        for (int remaining = processes; remaining > 0;) {
+            for (int p = 0; p < processes; ++p) {
+                if (progress[p] == instructions) continue;
+                const NameEntry& entry = *entries[p];
+                FILE* logFile = cache.acquire(entry, progress[p] == 0);
+                int end = std::min(instructions, progress[p] + quantum);
+                if (fused) {
+                    while (progress[p] < end) {
+                        int lines = std::min(InstructionBlock::maxLines, end - progress[p]);
+                        block.writePrints(logFile, clock.now(), 0, entry.message, lines);
+                        progress[p] += lines;
+                    }
+                } else {
+                    for (; progress[p] < end; ++progress[p]) {
+                        time_t now = time(0);
+                        tm ltm;
+#ifdef _WIN32
+                        localtime_s(&ltm, &now);
+#else
+                        localtime_r(&now, &ltm);
+#endif
+                        char timestamp[25];
+                        strftime(timestamp, sizeof(timestamp), "(%m/%d/%Y %I:%M:%S %p)", &ltm);
+                        fprintf(logFile, "%s Core:%d %s", timestamp, 0, entry.message.c_str());
+                    }
+                }
+                cache.release(entry.pid);
+                if (progress[p] == instructions) remaining--;
+            }
+        }
+        cache.closeAll();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    double perInstruction = run(false);
+    double fusedTime = run(true);
+
+    // Same records through both writers under one fixed timestamp must give the same bytes
+    const char* timestamp = "(01/01/2024 12:00:00 AM)";
+    const NameEntry& entry = *entries[0];
+    FILE* file = cache.acquire(entry, true);
+    for (int i = 0; i < quantum; ++i) {
+        fprintf(file, "%s Core:%d %s", timestamp, 3, entry.message.c_str());
+    }
+    cache.closeAll();
+    String expected = readFile(entry.logPath);
+    InstructionBlock block;
+    file = cache.acquire(entry, true);
+    block.writePrints(file, timestamp, 3, entry.message, quantum);
+    cache.closeAll();
+    bool identical = readFile(entry.logPath) == expected;
+
+    for (const NameEntry* e : entries) {
+        std::remove(e->logPath.c_str());
+    }
+
+    double total = static_cast<double>(processes) * instructions;
+    out << "\nInstruction path: " << processes << " processes of " << instructions
+        << " instructions, quantum " << quantum << ", no execution delay\n";
+    out << std::setw(18) << std::left << "" << std::setw(14) << "Time (s)" << "Instructions/s\n";
+    out << std::setw(18) << "per instruction" << std::setw(14) << perInstruction << total / perInstruction << "\n";
+    out << std::setw(18) << "fused blocks" << std::setw(14) << fusedTime << total / fusedTime << "\n";
+    out << "Speedup: " << perInstruction / fusedTime << "x, output " << (identical ? "identical" : "DIFFERS") << "\n\n";
+}
+
+static void writeReportRow(std::ostream& out, const ProcessRow& row) {
+    out << std::setw(10) << std::left << row.name << "   (" << row.timestamp << ")    Finished   "
+        << row.currentLine << " / " << row.totalLines << "\n";
+}
+
+// A report of many finished processes, written the old way (every row copied, the whole
+// report built in a string, then the file rewritten), streamed from the index, and as
+// an appended report of the few processes that changed since
+void benchmarkReport(std::ostream& out) {
+    const int processes = 200000;
+    const int changed = 100;
+    const char* path = "bench-report.txt";
+
+    NameTable names;
+    std::deque<Screen> screens;
+    ProcessIndex index(1);
+    for (int i = 0; i < processes; ++i) {
+        screens.emplace_back(names.intern("bench-report-" + std::to_string(i)), 100);
+        Screen& screen = screens.back();
+        snprintf(screen.timestamp, sizeof(screen.timestamp), "01/01/2024 12:00:00 AM");
+        screen.currentLine = 100;
+        index.add(screen);
+        index.setState(screen, ProcessState::Finished);
+    }
+
+    auto seconds = [](std::chrono::steady_clock::time_point since) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        ProcessQuery query;
+        query.pageSize = 0;
+        std::ostringstream report;
+        for (const ProcessRow& row : index.page(query, ProcessState::Finished).rows) {
+            writeReportRow(report, row);
+        }
+        std::ofstream file(path);
+        file << report.str();
+    }
+    double built = seconds(start);
+
+    start = std::chrono::steady_clock::now();
+    uint64_t reported = index.changeCount();
+    {
+        std::ofstream file(path);
+        index.scan(ProcessState::Finished, [&](const ProcessRow& row) { writeReportRow(file, row); });
+    }
+    double streamed = seconds(start);
+
+    // A few processes come back and finish again, then only those are reported
+    for (int i = 0; i < changed; ++i) {
+        index.setState(screens[i * (processes / changed)], ProcessState::Ready);
+        index.setState(screens[i * (processes / changed)], ProcessState::Finished);
+    }
+    start = std::chrono::steady_clock::now();
+    uint64_t upTo = 0;
+    size_t appended = 0;
+    {
+        std::ofstream file(path, std::ios::app);
+        for (const ProcessRow& row : index.changedSince(reported, upTo)) {
+            file << row.change << " ";
+            writeReportRow(file, row);
+            appended++;
+        }
+    }
+    double append = seconds(start);
+    std::remove(path);
+
+    out << "\nReport of " << processes << " finished processes, then " << changed << " changed\n";
+    out << std::setw(24) << std::left << "" << std::setw(14) << "Time (ms)" << "Rows held at once\n";
+    out << std::setw(24) << "built in memory" << std::setw(14) << built * 1e3 << processes << "\n";
+    out << std::setw(24) << "streamed" << std::setw(14) << streamed * 1e3 << "256\n";
+    out << std::setw(24) << "appended changes" << std::setw(14) << append * 1e3 << appended << "\n\n";
+}
+
+// Requeue cycles through each run queue (take a batch, charge it, put it back), log reopens
+// through a log cache smaller than the process count, and scratch lists. Every structure
+// first runs warm-up cycles that let its pools and arena grow; the heap allocations of the
+// measured cycles are what steady-state scheduling costs.
+void benchmarkPools(std::ostream& out) {
+    const int processes = 256;
+    const size_t batch = 8;
+    const int warmup = 1000;
+    const int cycles = 100000;
+    const int logProcesses = 64;
+    const int logCycles = 10000;
+
+    NameTable names;
+    const NameEntry& entry = names.intern("bench-pool");
+    std::vector<Screen> screens(processes, Screen(entry, 1000));
+    Config single;
+    single.num_cpu = 1;
+    single.core_affinity = true;
+    Screen* taken[batch];
+
+    out << "\nSteady-state allocations: " << processes << " processes, batches of " << batch
+        << ", after " << warmup << " warm-up cycles\n";
+    out << std::setw(26) << std::left << "" << std::setw(10) << "Cycles" << std::setw(14) << "Allocations" << "ns/cycle\n";
+
+    auto measure = [&](const char* label, int count, const std::function<void()>& cycle) {
+        for (int i = 0; i < warmup; ++i) cycle();
+        long long before = heapAllocationCount();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; ++i) cycle();
+        double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        out << std::setw(26) << label << std::setw(10) << count << std::setw(14) << heapAllocationCount() - before
+            << std::fixed << std::setprecision(1) << elapsed / count << "\n";
+        out.unsetf(std::ios::fixed);
+    };
+
+    // The cfs tree alone, with the default allocator and over a node pool
+    auto requeueTree = [&](auto& tree) {
+        for (size_t i = 0; i < batch; ++i) {
+            auto it = tree.begin();
+            taken[i] = it->second;
+            tree.erase(it);
+        }
+        for (size_t i = 0; i < batch; ++i) tree.emplace(taken[i]->vruntime += 1000, taken[i]);
+    };
+    {
+        std::multimap<long long, Screen*> tree;
+        for (auto& screen : screens) tree.emplace(0, &screen);
+        measure("multimap", cycles, [&]() { requeueTree(tree); });
+    }
+    {
+        typedef std::multimap<long long, Screen*, std::less<long long>,
+            PoolAllocator<std::pair<const long long, Screen*>>> PooledTree;
+        NodePool nodes;
+        PooledTree tree{ PooledTree::allocator_type(&nodes) };
+        for (auto& screen : screens) tree.emplace(0, &screen);
+        measure("multimap, node pool", cycles, [&]() { requeueTree(tree); });
+    }
+    {
+        CfsRunQueue queue(single);
+        for (auto& screen : screens) queue.push(&screen);
+        measure("cfs run queue", cycles, [&]() {
+            size_t count = queue.popBatch(0, taken, batch);
+            for (size_t i = 0; i < count; ++i) queue.charge(*taken[i], 1000000);
+            queue.pushBatch(0, taken, count);
+        });
+    }
+    {
+        SharedRunQueue queue(single);
+        for (auto& screen : screens) queue.push(&screen);
+        measure("core queues (fcfs/rr)", cycles, [&]() {
+            queue.pushBatch(0, taken, queue.popBatch(0, taken, batch));
+        });
+    }
+    {
+        LockedReadyQueue queue;
+        for (auto& screen : screens) queue.push(&screen);
+        measure("locked ready queue", cycles, [&]() {
+            queue.pushBatch(taken, queue.popBatch(taken, batch, 1));
+        });
+    }
+    {
+        std::vector<const NameEntry*> entries;
+        for (int i = 0; i < logProcesses; ++i) {
+            entries.push_back(&names.intern("bench-pool-" + std::to_string(i)));
+        }
+        LogCache cache(logProcesses / 8);
+        int next = 0;
+        measure("log cache, 1/8 open", logCycles, [&]() {
+            const NameEntry& logEntry = *entries[next++ % logProcesses];
+            cache.acquire(logEntry, false);
+            cache.release(logEntry.pid);
+        });
+        cache.closeAll();
+        for (const NameEntry* logEntry : entries) {
+            std::remove(logEntry->logPath.c_str());
+        }
+    }
+    measure("scratch list, vector", cycles, [&]() {
+        std::vector<Screen*> list;
+        for (size_t i = 0; i < batch; ++i) list.push_back(&screens[i]);
+    });
+    measure("scratch list, arena", cycles, [&]() {
+        ArenaScope scratch;
+        ScratchVector<Screen*> list;
+        for (size_t i = 0; i < batch; ++i) list.push_back(&screens[i]);
+    });
+    out << "\n";
+}
+
+void runBenchmark(const String& name) {
+    static const std::map<String, std::function<void(std::ostream&)>> benchmarks = {
+        { "ready-queue", benchmarkReadyQueue },
+        { "log-path", benchmarkLogPath },
+        { "dispatch-batch", benchmarkDispatchBatch },
+        { "dispatch-policy", benchmarkDispatchPolicy },
+        { "instruction-path", benchmarkInstructionPath },
+        { "report", benchmarkReport },
+        { "pools", benchmarkPools },
+    };
+
+    auto it = benchmarks.find(name);
+    if (it == benchmarks.end()) {
+        String names;
+        for (const auto& benchmark : benchmarks) {
+            names += " " + benchmark.first;
+        }
+        printInColor("Unknown benchmark. Available:" + names + "\n\n", "red");
+        return;
+    }
+    it->second(std::cout);
+}
@@ -0,0 +1,18 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "Utils.h"
+#include <ostream>
+
+// Microbenchmarks of scheduler building blocks, run from the main menu with "benchmark <name>"
+void runBenchmark(const String& name);
+
+void benchmarkReadyQueue(std::ostream& out);    // enqueue/dequeue throughput at 1-128 cores
+void benchmarkLogPath(std::ostream& out);       // heap allocations per dispatch when writing process logs
+void benchmarkDispatchBatch(std::ostream& out); // ready queue locks per instruction by dispatch batch size
+void benchmarkDispatchPolicy(std::ostream& out); // per-dispatch cost of each policy's scheduler
+void benchmarkInstructionPath(std::ostream& out); // instructions/s per core, one at a time vs fused blocks
+void benchmarkReport(std::ostream& out);        // report-util time: built in memory vs streamed vs changes only
+void benchmarkPools(std::ostream& out);         // heap allocations of steady-state requeues, log reopens and scratch lists
+
+#endif // BENCHMARK_H
@@ -0,0 +1,216 @@
+#include "CfsRunQueue.h"
+#include "Screen.h"
+#include "Utils.h"
+
+#include <algorithm>
+
+using std::max;
+using std::min;
+
+// Weight of each nice value from -20 to 19; every step is about 10% of CPU share
+static const int niceWeights[40] = {
+    88761, 71755, 56483, 46273, 36291,
+    29154, 23254, 18705, 14949, 11916,
+    9548, 7620, 6100, 4904, 3906,
+    3121, 2501, 1991, 1586, 1277,
+    1024, 820, 655, 526, 423,
+    335, 272, 215, 172, 137,
+    110, 87, 70, 56, 45,
+    36, 29, 23, 18, 15,
+};
+
+int CfsRunQueue::weightOf(int nice) {
+    return niceWeights[max(-20, min(19, nice)) + 20];
+}
+
+CfsRunQueue::CfsRunQueue(const Config& config)
+    : latencyTicks(config.quantum_cycles), minGranularity(config.min_granularity) {
+    for (int i = 0; i < config.num_cpu; ++i) {
+        trees.emplace_back(new CoreTree());
+    }
+}
+
+void CfsRunQueue::insert(CoreTree& core, Screen* screen) {
+    core.tree.emplace(screen->vruntime, screen);
+    core.totalWeight += weightOf(screen->nice);
+    core.size++;
+}
+
+Screen* CfsRunQueue::takeLeftmost(CoreTree& core) {
+    auto it = core.tree.begin();
+    Screen* screen = it->second;
+    core.tree.erase(it);
+    core.totalWeight -= weightOf(screen->nice);
+    core.size--;
+    core.minVruntime = max(core.minVruntime, screen->vruntime);
+    return screen;
+}
+
+int CfsRunQueue::leastLoaded() const {
+    int best = 0;
+    for (int i = 1; i < static_cast<int>(trees.size()); ++i) {
+        if (trees[i]->size < trees[best]->size) best = i;
+    }
+    return best;
+}
+
+int CfsRunQueue::busiest() const {
+    int best = 0;
+    for (int i = 1; i < static_cast<int>(trees.size()); ++i) {
+        if (trees[i]->size > trees[best]->size) best = i;
+    }
+    return best;
+}
+
+// Woken processes go back to the core they last ran on, new ones to the shortest tree.
+// An arrival starts no lower than the tree's minimum vruntime, so it neither starves
+// the processes already there nor gets starved by them.
+bool CfsRunQueue::push(Screen* screen) {
+    int coreId = screen->lastCoreId >= 0 && screen->lastCoreId < static_cast<int>(trees.size())
+        ? screen->lastCoreId : leastLoaded();
+    CoreTree& core = *trees[coreId];
+
+    std::lock_guard<ProfiledMutex> lock(core.mutex);
+    locks++;
+    screen->vruntime = max(screen->vruntime, core.minVruntime);
+    screen->coreId = coreId;
+    insert(core, screen);
+    return true;
+}
+
+// Deals a batch of new processes out over the trees, starting with the shortest
+size_t CfsRunQueue::pushNew(Screen* const* screens, size_t count) {
+    dealRuns(count, trees.size(), leastLoaded(), [&](int coreId, size_t begin, size_t end) {
+        CoreTree& core = *trees[coreId];
+        std::lock_guard<ProfiledMutex> lock(core.mutex);
+        locks++;
+        for (size_t i = begin; i < end; ++i) {
+            screens[i]->vruntime = max(screens[i]->vruntime, core.minVruntime);
+            screens[i]->coreId = coreId;
+            insert(core, screens[i]);
+        }
+    });
+    return count;
+}
+
+// Takes the lowest-vruntime process of this core's tree; an empty core steals the most
+// urgent process of the busiest tree instead of going idle. Only one is taken whatever
+// dispatch-batch says: a batch would be round-robined on the core regardless of vruntime,
+// so each quantum must go back through the tree to pick the next process.
+size_t CfsRunQueue::popBatch(int coreId, Screen** out, size_t maxCount) {
+    size_t count = 0;
+    {
+        CoreTree& core = *trees[coreId];
+        std::lock_guard<ProfiledMutex> lock(core.mutex);
+        locks++;
+        if (maxCount > 0 && !core.tree.empty()) {
+            out[count++] = takeLeftmost(core);
+        }
+    }
+    if (count > 0 || maxCount == 0) return count;
+
+    int victim = busiest();
+    if (victim == coreId || trees[victim]->size == 0) return 0;
+
+    CoreTree& core = *trees[victim];
+    std::lock_guard<ProfiledMutex> lock(core.mutex);
+    locks++;
+    if (core.tree.empty()) return 0;
+    out[count++] = takeLeftmost(core);
+    migrations++;
+    return count;
+}
+
+// Preempted processes keep their vruntime, but never below the tree's floor
+size_t CfsRunQueue::pushBatch(int coreId, Screen* const* screens, size_t count) {
+    CoreTree& core = *trees[coreId];
+    std::lock_guard<ProfiledMutex> lock(core.mutex);
+    locks++;
+    for (size_t i = 0; i < count; ++i) {
+        screens[i]->vruntime = max(screens[i]->vruntime, core.minVruntime);
+        insert(core, screens[i]);
+    }
+    return count;
+}
+
+// Gives up the least urgent processes of the busiest trees, as balance does
+size_t CfsRunQueue::shed(Screen** out, size_t maxCount) {
+    size_t count = 0;
+    while (count < maxCount) {
+        CoreTree& core = *trees[busiest()];
+        if (core.size == 0) break;
+
+        std::lock_guard<ProfiledMutex> lock(core.mutex);
+        locks++;
+        if (core.tree.empty()) continue;
+        auto it = std::prev(core.tree.end());
+        Screen* screen = it->second;
+        core.tree.erase(it);
+        core.totalWeight -= weightOf(screen->nice);
+        core.size--;
+        out[count++] = screen;
+    }
+    return count;
+}
+
+bool CfsRunQueue::empty(int) const {
+    for (const auto& core : trees) {
+        if (core->size > 0) return false;
+    }
+    return true;
+}
+
+// The core's latency period split by weight between the dispatched process and the
+// processes waiting behind it, but never shorter than min-granularity
+long long CfsRunQueue::timeSlice(int coreId, const Screen& screen) const {
+    long long weight = weightOf(screen.nice);
+    long long waiting;
+    {
+        CoreTree& core = *trees[coreId];
+        std::lock_guard<ProfiledMutex> lock(core.mutex);
+        locks++;
+        waiting = core.totalWeight;
+    }
+    return max<long long>(minGranularity, latencyTicks * weight / (waiting + weight));
+}
+
+// Time on a core advances vruntime inversely to weight; nice 0 advances at real time
+void CfsRunQueue::charge(Screen& screen, long long ranNs) {
+    screen.vruntime += ranNs * weightOf(0) / weightOf(screen.nice);
+}
+
+// Moves processes from the busiest tree to the shortest one until their sizes are within
+// one. Moved processes keep their lead over the old tree's minimum vruntime, and never
+// start below the new tree's.
+void CfsRunQueue::balance(const std::function<void(int)>& wake) {
+    int from = busiest();
+    int to = leastLoaded();
+    if (from == to || trees[from]->size < trees[to]->size + 2) return;
+
+    CoreTree& source = *trees[from];
+    CoreTree& target = *trees[to];
+    size_t moved = 0;
+    {
+        std::unique_lock<ProfiledMutex> sourceLock(source.mutex, std::defer_lock);
+        std::unique_lock<ProfiledMutex> targetLock(target.mutex, std::defer_lock);
+        std::lock(sourceLock, targetLock);
+        locks += 2;
+
+        while (source.tree.size() >= target.tree.size() + 2) {
+            // The least urgent process has the least to lose from moving
+            auto it = std::prev(source.tree.end());
+            Screen* screen = it->second;
+            source.tree.erase(it);
+            source.totalWeight -= weightOf(screen->nice);
+            source.size--;
+
+            screen->vruntime = target.minVruntime + max(0LL, screen->vruntime - source.minVruntime);
+            screen->coreId = to;
+            insert(target, screen);
+            moved++;
+        }
+    }
+
+    migrations += moved;
+    if (moved > 0) wake(to);
+}
@@ -0,0 +1,65 @@
+#ifndef CFSRUNQUEUE_H
+#define CFSRUNQUEUE_H
+
+#include "Config.h"
+#include "Pool.h"
+#include "Profiler.h"
+#include <map>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <functional>
+
+class Screen;
+
+// Run queue of the completely fair policy: one tree per core ordered by virtual runtime,
+// so a core always runs its waiting process that has had the least weighted CPU time.
+// Idle cores steal from the busiest tree and a periodic balance evens the trees out.
+class CfsRunQueue {
+private:
+    typedef std::multimap<long long, Screen*, std::less<long long>,
+        PoolAllocator<std::pair<const long long, Screen*>>> Tree;
+
+    struct CoreTree {
+        ProfiledMutex mutex{ LockSite::CfsTree };
+        NodePool nodes;                             // tree nodes, reused by every requeue
+        Tree tree;                                  // vruntime -> process (red-black tree)
+        long long minVruntime = 0;                  // never decreases; floor for arrivals
+        long long totalWeight = 0;                  // of the waiting processes
+        std::atomic<size_t> size{ 0 };
+
+        CoreTree() : tree(Tree::allocator_type(&nodes)) {}
+    };
+
+    std::vector<std::unique_ptr<CoreTree>> trees;
+    int latencyTicks;           // period in which every waiting process of a core runs once
+    int minGranularity;         // shortest slice in ticks
+    mutable std::atomic<long long> locks{ 0 };
+    std::atomic<long long> migrations{ 0 };
+
+    void insert(CoreTree& core, Screen* screen);
+    Screen* takeLeftmost(CoreTree& core);
+    int leastLoaded() const;
+    int busiest() const;
+
+public:
+    explicit CfsRunQueue(const Config& config);
+    bool push(Screen* screen);
+    void pushOverflow(Screen* screen) { push(screen); }    // the trees are unbounded                          // new or woken process
+    size_t pushNew(Screen* const* screens, size_t count);   // new processes, spread over the trees
+    size_t popBatch(int coreId, Screen** out, size_t maxCount);
+    size_t pushBatch(int coreId, Screen* const* screens, size_t count);  // preempted processes
+    size_t shed(Screen** out, size_t maxCount);         // processes leaving for another shard
+    bool empty(int coreId) const;                       // nothing waiting on any core
+    long long lockCount() const { return locks; }
+    long long migrationCount() const { return migrations; }
+
+    long long timeSlice(int coreId, const Screen& screen) const;   // in ticks
+    void charge(Screen& screen, long long ranNs);                   // advance vruntime
+    void balance(const std::function<void(int)>& wake);            // even out the trees
+
+    static int weightOf(int nice);
+};
+
+#endif // CFSRUNQUEUE_H
@@ -0,0 +1,305 @@
+#include "ClusterNode.h"
+
+#include <new>
+#include <chrono>
+#include <thread>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+static const int joinAttempts = 100;    // 10 ms apart, while the creator sets the region up
+
+static long long wallMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static int currentProcessId() {
+#ifdef _WIN32
+    return static_cast<int>(GetCurrentProcessId());
+#else
+    return static_cast<int>(getpid());
+#endif
+}
+
+ClusterNode::~ClusterNode() {
+    detach();
+}
+
+// Maps the region, creating and initializing it if no shard has yet. A joining process
+// waits until the creator has published the magic.
+bool ClusterNode::map(int shards, String& error) {
+    void* memory = nullptr;
+    bool created = false;
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0,
+        static_cast<DWORD>(sizeof(ClusterRegion)), clusterRegionName);
+    if (!handle) {
+        error = "could not create shared memory " + String(clusterRegionName);
+        return false;
+    }
+    created = GetLastError() != ERROR_ALREADY_EXISTS;
+
+    memory = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(ClusterRegion));
+    if (!memory) {
+        CloseHandle(handle);
+        error = "could not map shared memory " + String(clusterRegionName);
+        return false;
+    }
+    mapping = handle;
+#else
+    int fd = shm_open(clusterRegionName, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd >= 0) {
+        created = true;
+        if (ftruncate(fd, sizeof(ClusterRegion)) != 0) {
+            ::close(fd);
+            shm_unlink(clusterRegionName);
+            error = "could not size shared memory " + String(clusterRegionName);
+            return false;
+        }
+    }
+    else if (errno == EEXIST) {
+        fd = shm_open(clusterRegionName, O_RDWR, 0);
+        struct stat info;
+        for (int i = 0; fd >= 0 && i < joinAttempts; ++i) {
+            if (fstat(fd, &info) == 0 && info.st_size >= static_cast<off_t>(sizeof(ClusterRegion))) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        if (fd < 0 || fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(ClusterRegion))) {
+            if (fd >= 0) ::close(fd);
+            error = "shared memory " + String(clusterRegionName) + " has an unknown layout";
+            return false;
+        }
+    }
+    if (fd < 0) {
+        error = "could not open shared memory " + String(clusterRegionName);
+        return false;
+    }
+    memory = mmap(nullptr, sizeof(ClusterRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        if (created) shm_unlink(clusterRegionName);
+        error = "could not map shared memory " + String(clusterRegionName);
+        return false;
+    }
+#endif
+
+    if (created) {
+        // Joiners ignore the region until the magic is in place
+        region = new (memory) ClusterRegion();
+        region->version = clusterRegionVersion;
+        region->size = sizeof(ClusterRegion);
+        region->shardCount = static_cast<uint32_t>(shards);
+        std::atomic_thread_fence(std::memory_order_release);
+        region->magic = clusterRegionMagic;
+    }
+    else {
+        region = static_cast<ClusterRegion*>(memory);
+        for (int i = 0; i < joinAttempts && region->magic != clusterRegionMagic; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (region->magic != clusterRegionMagic || region->version != clusterRegionVersion
+            || region->size != sizeof(ClusterRegion)) {
+            error = "shared memory " + String(clusterRegionName) + " has an unknown layout (version "
+                + std::to_string(region->version) + ")";
+            unmap();
+            return false;
+        }
+    }
+    return true;
+}
+
+void ClusterNode::unmap() {
+    if (!region) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(region);
+    CloseHandle(static_cast<HANDLE>(mapping));
+    mapping = nullptr;
+#else
+    munmap(region, sizeof(ClusterRegion));
+#endif
+    region = nullptr;
+}
+
+// Takes the first free slot, or the slot of a shard that stopped publishing. Processes
+// still in flight to a dead shard wait in its inbox and are adopted by the new owner.
+bool ClusterNode::claimShard(int periodMs) {
+    long long now = wallMs();
+    for (int i = 0; i < shardCount(); ++i) {
+        ClusterShard& slot = region->shards[i];
+        uint32_t state = slot.state.load();
+        bool dead = state != shardFree && !isLive(i);
+        if ((state != shardFree && !dead) || !slot.state.compare_exchange_strong(state, shardClaimed)) {
+            continue;
+        }
+
+        slot.ownerPid = currentProcessId();
+        slot.periodMs = periodMs;
+        slot.heartbeatMs = now;
+        slot.cores = 0;
+        slot.ready = 0;
+        slot.emigrated = 0;
+        slot.immigrated = 0;
+        slot.sequence.store(slot.sequence.load() + 1);
+        memset(&slot.snapshot, 0, sizeof(slot.snapshot));
+        slot.sequence.store(slot.sequence.load() + 1, std::memory_order_release);
+        slot.state.store(shardActive, std::memory_order_release);
+        shard = i;
+        return true;
+    }
+    return false;
+}
+
+bool ClusterNode::attach(int shards, int periodMs, String& error) {
+    detach();
+    if (!map(shards, error)) return false;
+
+    if (!claimShard(periodMs)) {
+        error = "all " + std::to_string(shardCount()) + " shards are taken";
+        detach();
+        return false;
+    }
+    return true;
+}
+
+// Gives up the shard slot. The last live shard to leave removes the region, so the next
+// cluster starts from a clean one even after shards crashed; Windows does that when the
+// last view is unmapped. A process joining at that very moment ends up alone in the
+// removed region.
+void ClusterNode::detach() {
+    if (!region) return;
+
+    if (shard >= 0) {
+        ClusterShard& slot = region->shards[shard];
+        slot.ready = 0;
+        slot.heartbeatMs = 0;
+        slot.state.store(shardFree, std::memory_order_release);
+        shard = -1;
+    }
+    bool last = true;
+    for (int i = 0; i < shardCount(); ++i) {
+        if (isLive(i)) last = false;
+    }
+    unmap();
+#ifndef _WIN32
+    if (last) shm_unlink(clusterRegionName);
+#else
+    (void)last;
+#endif
+}
+
+int ClusterNode::shardCount() const {
+    return region ? static_cast<int>(region->shardCount) : 0;
+}
+
+long long ClusterNode::allocatePid() {
+    return region->nextPid.fetch_add(1) + 1;
+}
+
+long long ClusterNode::allocatePids(long long count) {
+    return region->nextPid.fetch_add(count) + 1;
+}
+
+void ClusterNode::publish(const StatusSnapshot& snapshot) {
+    ClusterShard& slot = region->shards[shard];
+    slot.cores = snapshot.numCores;
+    slot.ready = snapshot.ready;
+    slot.heartbeatMs = wallMs();
+
+    uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&slot.snapshot, &snapshot, sizeof(snapshot));
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+// A shard is dead once it has missed a few publishes; the slack covers a busy host
+bool ClusterNode::isLive(int other) const {
+    const ClusterShard& slot = region->shards[other];
+    if (slot.state.load(std::memory_order_acquire) != shardActive) return false;
+    return wallMs() - slot.heartbeatMs.load() <= 3 * slot.periodMs + 2000;
+}
+
+// Processes this shard has sent but the target has not picked up yet count as its load,
+// so a slow receiver is not flooded
+int ClusterNode::leastLoaded(long long& ready, long long& cores) const {
+    int best = -1;
+    for (int i = 0; i < shardCount(); ++i) {
+        if (i == shard || !isLive(i)) continue;
+
+        const ClusterShard& slot = region->shards[i];
+        long long load = slot.ready + (clusterRingSlots - freeSlots(i));
+        long long count = slot.cores;
+        if (count <= 0) continue;
+        if (best < 0 || load * cores < ready * count) {
+            best = i;
+            ready = load;
+            cores = count;
+        }
+    }
+    return best;
+}
+
+size_t ClusterNode::freeSlots(int target) const {
+    const ClusterRing& ring = region->shards[target].inbox[shard];
+    uint32_t used = ring.tail.load(std::memory_order_relaxed) - ring.head.load(std::memory_order_acquire);
+    return clusterRingSlots - used;
+}
+
+bool ClusterNode::send(int target, const ClusterProcess& process) {
+    ClusterRing& ring = region->shards[target].inbox[shard];
+    uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+    if (tail - ring.head.load(std::memory_order_acquire) >= clusterRingSlots) return false;
+
+    ring.slots[tail % clusterRingSlots] = process;
+    ring.tail.store(tail + 1, std::memory_order_release);
+    region->shards[shard].emigrated++;
+    return true;
+}
+
+size_t ClusterNode::receive(std::vector<ClusterProcess>& out) {
+    ClusterShard& slot = region->shards[shard];
+    size_t count = 0;
+    for (int sender = 0; sender < clusterMaxShards; ++sender) {
+        ClusterRing& ring = slot.inbox[sender];
+        uint32_t head = ring.head.load(std::memory_order_relaxed);
+        uint32_t tail = ring.tail.load(std::memory_order_acquire);
+        while (head != tail) {
+            out.push_back(ring.slots[head % clusterRingSlots]);
+            ring.head.store(++head, std::memory_order_release);
+            count++;
+        }
+    }
+    slot.immigrated += count;
+    return count;
+}
+
+size_t ClusterNode::readShards(std::vector<ShardStatus>& out) const {
+    for (int i = 0; i < shardCount(); ++i) {
+        if (!isLive(i)) continue;
+
+        const ClusterShard& slot = region->shards[i];
+        ShardStatus status;
+        status.shard = i;
+        status.ownerPid = slot.ownerPid;
+        status.emigrated = slot.emigrated;
+        status.immigrated = slot.immigrated;
+        if (readSnapshot(slot.sequence, slot.snapshot, status.snapshot)) {
+            out.push_back(status);
+        }
+    }
+    return out.size();
+}
@@ -0,0 +1,55 @@
+#ifndef CLUSTERNODE_H
+#define CLUSTERNODE_H
+
+#include "ClusterRegion.h"
+#include "Utils.h"
+#include <vector>
+
+// Published state of one shard, copied out of the region
+struct ShardStatus {
+    int shard;
+    int ownerPid;
+    long long emigrated;
+    long long immigrated;
+    StatusSnapshot snapshot;
+};
+
+// This process's membership in a cluster: maps the shared region (creating it if this is
+// the first shard), owns one shard slot and exchanges migrated processes with the other
+// shards. Only the scheduler's tick thread publishes, sends and receives.
+class ClusterNode {
+private:
+    ClusterRegion* region = nullptr;
+    int shard = -1;
+#ifdef _WIN32
+    void* mapping = nullptr;            // HANDLE of the file mapping
+#endif
+
+    bool map(int shards, String& error);
+    void unmap();
+    bool claimShard(int periodMs);
+
+public:
+    ClusterNode() = default;
+    ~ClusterNode();
+    ClusterNode(const ClusterNode&) = delete;
+    ClusterNode& operator=(const ClusterNode&) = delete;
+
+    bool attach(int shards, int periodMs, String& error);  // join or create the cluster and claim a free shard
+    void detach();
+    bool isAttached() const { return shard >= 0; }
+    int shardId() const { return shard; }
+    int shardCount() const;
+
+    long long allocatePid();            // next cluster-wide process ID
+    long long allocatePids(long long count);    // first of count consecutive IDs
+    void publish(const StatusSnapshot& snapshot);   // heartbeat, load and snapshot of this shard
+    bool isLive(int other) const;
+    int leastLoaded(long long& ready, long long& cores) const;  // other live shard with the fewest ready per core, -1 if none
+    size_t freeSlots(int target) const; // room in this shard's ring to target
+    bool send(int target, const ClusterProcess& process);
+    size_t receive(std::vector<ClusterProcess>& out);   // drains every ring into this shard
+    size_t readShards(std::vector<ShardStatus>& out) const;     // every live shard, this one included
+};
+
+#endif // CLUSTERNODE_H
@@ -0,0 +1,72 @@
+#ifndef CLUSTERREGION_H
+#define CLUSTERREGION_H
+
+#include "StatusPage.h"
+
+#include <atomic>
+#include <cstdint>
+
+// Layout of the shared-memory region that joins emulator processes on one host into a
+// cluster (see ClusterNode). Every process owns one shard slot: it publishes its status
+// snapshot and load there, and receives migrated processes in one ring per sending
+// shard. Each ring has a single producer and a single consumer and the snapshot is a
+// seqlock, so no lock is ever shared between processes.
+
+#ifdef _WIN32
+static const char* const clusterRegionName = "Local\\WindowPainCluster";
+#else
+static const char* const clusterRegionName = "/windowpain-cluster";
+#endif
+
+static const uint32_t clusterRegionMagic = 0x4c435057;    // "WPCL"
+static const uint32_t clusterRegionVersion = 1;            // bumped whenever the layout changes
+static const int clusterMaxShards = 16;
+static const uint32_t clusterRingSlots = 64;
+
+static const uint32_t shardFree = 0;
+static const uint32_t shardClaimed = 1;     // being set up by a joining process
+static const uint32_t shardActive = 2;
+
+// A ready process in transit to another shard
+struct ClusterProcess {
+    char name[statusNameLength];
+    char timestamp[24];
+    int64_t globalPid;
+    int64_t cpuTicks;
+    int32_t currentLine;
+    int32_t totalLines;
+    int32_t nice;
+    int32_t fromShard;
+};
+
+// Written only by the sending shard, read only by the receiving one
+struct ClusterRing {
+    std::atomic<uint32_t> head;         // next slot to read, advanced by the receiver
+    std::atomic<uint32_t> tail;         // next slot to write, advanced by the sender
+    ClusterProcess slots[clusterRingSlots];
+};
+
+struct ClusterShard {
+    std::atomic<uint32_t> state;        // shardFree, shardClaimed or shardActive
+    int32_t ownerPid;                   // OS process ID of the owner
+    std::atomic<int64_t> heartbeatMs;   // wall clock of the last publish
+    int64_t periodMs;                   // time between publishes; a shard silent for much longer is dead
+    std::atomic<int64_t> cores;         // load, updated with every publish
+    std::atomic<int64_t> ready;
+    std::atomic<int64_t> emigrated;     // processes sent to other shards
+    std::atomic<int64_t> immigrated;    // processes received from other shards
+    std::atomic<uint64_t> sequence;     // odd while the snapshot is being rewritten
+    StatusSnapshot snapshot;
+    ClusterRing inbox[clusterMaxShards];    // indexed by sending shard
+};
+
+struct ClusterRegion {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;                      // sizeof(ClusterRegion) of the creator
+    uint32_t shardCount;                // slots in use, fixed by the creator
+    std::atomic<int64_t> nextPid;       // cluster-wide process IDs
+    ClusterShard shards[clusterMaxShards];
+};
+
+#endif // CLUSTERREGION_H
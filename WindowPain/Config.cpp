@@ -1,5 +1,4 @@
 #include "Config.h"
 #include <type_traits>
 
-Config config;
-std::atomic<int> activeCores = 0;
\ No newline at end of file
+Config config;
\ No newline at end of file
@@ -6,18 +6,44 @@
 
 struct Config {
     int num_cpu = 1;
-    std::string scheduler = "fcfs";
-    int quantum_cycles = 1;
+    std::string scheduler = "fcfs";             // "fcfs", "rr" or "cfs"
+    int quantum_cycles = 1;                     // rr: slice in ticks; cfs: latency period in ticks
     int batch_process_freq = 1;
     int min_ins = 1;
     int max_ins = 1;
     int delays_per_exec = 0;
+    int max_overall_mem = 0;                    // 0 disables the memory model
+    int mem_per_ins = 1;                        // bytes of memory per instruction
+    std::string memory_allocator = "first-fit";
+    int memory_snapshot_quanta = 0;             // 0 disables memory snapshots
+    std::string ready_queue = "locked";         // "locked" or "ring"
+    int ready_queue_capacity = 4096;            // slots preallocated by the ring
+    int log_cache_size = 64;                    // per-process log files kept open
+    int dispatch_batch = 1;                     // most processes a core takes at once
+    int min_granularity = 1;                    // cfs: shortest time slice in ticks
+    int balance_interval = 4;                   // ticks between run queue load balancing
+    bool core_affinity = true;                  // fcfs/rr: requeue processes on the core they last ran on
+    int migration_penalty = 0;                  // ticks a process stalls after moving to another core
+    int tick_ms = 50;                           // scheduler tick period; RR quanta are counted in ticks
+    int mailbox_slots = 16;                     // message slots per pipe
+    int trace_buffer_events = 0;                // events kept per core for trace-export (0 disables tracing)
+    int max_ready = 0;                          // processes waiting in the ready queue before admission stops (0 for no limit)
+    int max_live = 0;                           // unfinished processes before admission stops (0 for no limit)
+    std::string admission_policy = "block";     // "block", "drop" or "defer" when a limit is reached
+    int status_page_ticks = 1;                  // ticks between shared-memory status page updates (0 disables)
+    int cluster_shards = 0;                     // shard slots of the host's cluster region (0 runs standalone)
+    int cluster_balance_ticks = 10;             // ticks between cluster publishes and cross-shard balancing
+    bool profile = false;                       // time locks and log I/O for profile-dump
+    bool process_logs = true;                   // write <name>.txt logs (off only in benchmarks)
+    int io_devices = 0;                         // emulated I/O devices (0 disables I/O instructions)
+    int io_interval = 10;                       // print instructions an I/O-bound process runs between I/O requests
+    int io_bound_percent = 50;                  // share of new processes that are I/O-bound
+    int io_service_ms = 20;                     // mean device service time per request
+    std::string io_service_dist = "exponential";    // "fixed", "uniform" (0 to twice the mean) or "exponential"
 };
 
 extern Config config;
 
-extern std::atomic<int> activeCores;
-
 template <typename T1, typename T2, typename T3>
 auto clamp(const T1& v, const T2& lo, const T3& hi) -> typename std::common_type<T1, T2, T3>::type {
     using CommonType = typename std::common_type<T1, T2, T3>::type;
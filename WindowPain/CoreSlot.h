@@ -0,0 +1,49 @@
+#ifndef CORESLOT_H
+#define CORESLOT_H
+
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include "InstructionBlock.h"
+
+struct NameEntry;
+
+// Per-core parking slot and time accounting. A parked core sleeps on its own
+// condition variable, so an enqueue wakes exactly the core it picked.
+struct CoreSlot {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool wakePending = false;                               // guarded by mutex
+    std::chrono::steady_clock::time_point wakeRequested;    // guarded by mutex
+
+    std::atomic<bool> busy{ false };                        // running a process
+    std::atomic<long long> generation{ 0 };                 // stamps each dispatch on this core
+    std::atomic<long long> preemptGeneration{ -1 };         // dispatch whose quantum the tick thread found used up
+    std::atomic<long long> dispatchTick{ -1 };              // tick the current process was dispatched at (-1 if none)
+    std::atomic<long long> sliceTicks{ -1 };                // ticks it may run before preemption (-1 for no limit)
+    std::atomic<const NameEntry*> running{ nullptr };       // process on the core, for the status page
+
+    // Written by the owning core, read by core-stat
+    std::atomic<long long> busyNs{ 0 };             // executing processes
+    std::atomic<long long> parkedNs{ 0 };           // asleep waiting for work
+    std::atomic<long long> pollNs{ 0 };             // polling the ready queue before parking
+    std::atomic<long long> wakeups{ 0 };
+    std::atomic<long long> wakeLatencyNs{ 0 };      // total time from wake request to running
+    std::atomic<long long> maxWakeLatencyNs{ 0 };
+    std::atomic<long long> migrationsIn{ 0 };       // processes that last ran on another core
+    std::atomic<long long> migrationsOut{ 0 };      // processes that last ran here, dispatched elsewhere
+    std::atomic<long long> migrationStallNs{ 0 };   // migration penalty served
+    std::atomic<long long> allocations{ 0 };        // heap allocations by the core's thread, updated after every dispatch
+    long long reportedAllocations = 0;              // allocations at the last alloc-stat, console only
+
+    // Used only by the owning core while it executes instructions
+    TimestampCache clock;
+    InstructionBlock block;
+
+    // Written by the tick thread
+    std::atomic<long long> busyTicks{ 0 };
+    std::atomic<long long> idleTicks{ 0 };
+};
+
+#endif // CORESLOT_H
@@ -0,0 +1,39 @@
+#include "InstructionBlock.h"
+#include "Arena.h"
+
+#include <cstring>
+
+const char* TimestampCache::now() {
+    time_t current = time(0);
+    if (current != second) {
+        tm ltm;
+#ifdef _WIN32
+        localtime_s(&ltm, &current);
+#else
+        localtime_r(&current, &ltm);
+#endif
+        strftime(text, sizeof(text), "(%m/%d/%Y %I:%M:%S %p)", &ltm);
+        second = current;
+    }
+    return text;
+}
+
+// Formats one "<timestamp> Core:<id> <message>" record and repeats it count times
+void InstructionBlock::writePrints(FILE* file, const char* timestamp, int coreId, const String& message, int count) {
+    if (!file || count <= 0) return;
+
+    char prefix[48];
+    int prefixLength = snprintf(prefix, sizeof(prefix), "%s Core:%d ", timestamp, coreId);
+    if (prefixLength < 0) return;
+    size_t recordLength = static_cast<size_t>(prefixLength) + message.size();
+
+    size_t total = recordLength * static_cast<size_t>(count);
+    ArenaScope scratch;
+    char* out = static_cast<char*>(Arena::local().allocate(total));
+    memcpy(out, prefix, static_cast<size_t>(prefixLength));
+    memcpy(out + prefixLength, message.data(), message.size());
+    for (int i = 1; i < count; ++i) {
+        memcpy(out + recordLength * i, out, recordLength);
+    }
+    fwrite(out, 1, total, file);
+}
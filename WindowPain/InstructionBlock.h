@@ -0,0 +1,30 @@
+#ifndef INSTRUCTIONBLOCK_H
+#define INSTRUCTIONBLOCK_H
+
+#include "Utils.h"
+#include <cstdio>
+#include <ctime>
+
+// Log timestamp "(%m/%d/%Y %I:%M:%S %p)" formatted at most once per second. Each core
+// owns one, so no locking is needed.
+class TimestampCache {
+private:
+    time_t second = -1;
+    char text[25] = "";
+
+public:
+    const char* now();
+};
+
+// Straight-line run of print instructions executed as one block: the log records of
+// the whole block are formatted into one buffer and written with a single fwrite.
+// Produces exactly the bytes the per-instruction path writes with fprintf. The buffer is
+// scratch on the calling thread's arena.
+class InstructionBlock {
+public:
+    static const int maxLines = 1024;   // instructions per block; preemption is checked between blocks
+
+    void writePrints(FILE* file, const char* timestamp, int coreId, const String& message, int count);
+};
+
+#endif // INSTRUCTIONBLOCK_H
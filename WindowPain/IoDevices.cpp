@@ -0,0 +1,175 @@
+#include "IoDevices.h"
+#include "Screen.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+
+using std::max;
+
+IoDevices::IoDevices(const Config& config, std::function<void(Screen&)> complete)
+    : ioInterval(config.io_interval), boundPercent(config.io_bound_percent), meanServiceMs(config.io_service_ms),
+    distribution(ServiceDistribution::Exponential), complete(std::move(complete)), origin(std::chrono::steady_clock::now()) {
+    parseDistribution(config.io_service_dist, distribution);
+
+    std::random_device rd;
+    unsigned seed = rd();
+    for (int i = 0; i < config.io_devices; ++i) {
+        std::seed_seq stream{ seed, static_cast<unsigned>(i) };
+        devices.emplace_back(new Device(stream));
+    }
+}
+
+IoDevices::~IoDevices() {
+    stop();
+}
+
+bool IoDevices::parseDistribution(const String& value, ServiceDistribution& distribution) {
+    if (value == "fixed") distribution = ServiceDistribution::Fixed;
+    else if (value == "uniform") distribution = ServiceDistribution::Uniform;
+    else if (value == "exponential") distribution = ServiceDistribution::Exponential;
+    else return false;
+    return true;
+}
+
+// Spreads I/O-bound processes over the devices by pid, so the choice needs no lock and a
+// process keeps its device. Pipe ends stay CPU-bound: every instruction of theirs is a
+// SEND or RECV.
+void IoDevices::assign(Screen& screen) const {
+    if (!enabled() || screen.outbox || screen.inbox) return;
+
+    unsigned hash = static_cast<unsigned>(screen.pid) * 2654435761u;
+    if (static_cast<int>((hash >> 16) % 100) < boundPercent) {
+        screen.ioInterval = ioInterval;
+        screen.ioDevice = screen.pid % count();
+    }
+}
+
+void IoDevices::submit(Screen& screen) {
+    Device& device = *devices[screen.ioDevice];
+    {
+        std::lock_guard<ProfiledMutex> lock(device.mutex);
+        device.requests.push_back({ &screen, std::chrono::steady_clock::now() });
+        device.peakQueued = max(device.peakQueued, device.requests.size());
+    }
+    device.arrived.notify_one();
+}
+
+void IoDevices::start() {
+    for (int i = 0; i < count(); ++i) {
+        devices[i]->thread = std::thread(&IoDevices::serve, this, i);
+    }
+}
+
+void IoDevices::stop() {
+    stopping = true;
+    for (auto& device : devices) {
+        {
+            std::lock_guard<ProfiledMutex> lock(device->mutex);
+        }
+        device->arrived.notify_all();
+    }
+    for (auto& device : devices) {
+        if (device->thread.joinable()) device->thread.join();
+    }
+}
+
+std::chrono::microseconds IoDevices::serviceTime(std::mt19937& generator) const {
+    double ms = meanServiceMs;
+    if (distribution == ServiceDistribution::Uniform) {
+        ms = std::uniform_real_distribution<double>(0.0, 2.0 * meanServiceMs)(generator);
+    }
+    else if (distribution == ServiceDistribution::Exponential && meanServiceMs > 0) {
+        ms = std::exponential_distribution<double>(1.0 / meanServiceMs)(generator);
+    }
+    return std::chrono::microseconds(static_cast<long long>(ms * 1000));
+}
+
+// Device thread. The lock is only held while the device waits, so processes keep queuing
+// requests during a service; the completion runs with it dropped.
+void IoDevices::serve(int deviceId) {
+    Device& device = *devices[deviceId];
+    std::unique_lock<ProfiledMutex> lock(device.mutex);
+
+    while (!stopping) {
+        device.arrived.wait(lock, [&] { return stopping || !device.requests.empty(); });
+        if (stopping) break;
+
+        Request request = device.requests.front();
+        device.requests.pop_front();
+        device.waitNs += elapsedNs(request.queued);
+        device.serviceStart = std::chrono::steady_clock::now();
+        device.busy = true;
+
+        auto done = device.serviceStart + serviceTime(device.generator);
+        if (device.arrived.wait_until(lock, done, [&] { return stopping.load(); })) break;
+
+        device.busyNs += elapsedNs(device.serviceStart);
+        device.served++;
+        device.busy = false;
+        lock.unlock();
+        complete(*request.screen);
+        lock.lock();
+    }
+    device.busy = false;
+}
+
+void IoDevices::sample(bool coreBusy) {
+    sampledTicks++;
+    if (busyCount() == 0) return;
+    deviceBusyTicks++;
+    if (coreBusy) overlapTicks++;
+}
+
+int IoDevices::busyCount() const {
+    int busy = 0;
+    for (const auto& device : devices) {
+        if (device->busy) busy++;
+    }
+    return busy;
+}
+
+size_t IoDevices::queuedCount() const {
+    size_t queued = 0;
+    for (const auto& device : devices) {
+        std::lock_guard<ProfiledMutex> lock(device->mutex);
+        queued += device->requests.size();
+    }
+    return queued;
+}
+
+// Printed under the CPU utilization of screen -ls and report-util. Busy% covers the whole
+// run, the device line only the moment of the listing, like the CPU line above it.
+void IoDevices::printUtilization(std::ostream& out) const {
+    int busy = busyCount();
+    long long ticks = sampledTicks;
+    long long elapsed = max(1LL, elapsedNs(origin));
+
+    out << "Device Utilization: " << 100.0 * busy / count() << "%" << "\n";
+    out << "Devices Used: " << busy << "\n";
+    out << "Requests Queued: " << queuedCount() << "\n";
+    out << std::fixed << std::setprecision(1);
+    out << "I/O Overlap: " << (ticks ? 100.0 * overlapTicks / ticks : 0.0) << "% of ticks with a core and a device busy, "
+        << (ticks ? 100.0 * deviceBusyTicks / ticks : 0.0) << "% with a device busy\n";
+
+    out << "\n";
+    out << std::setw(8) << std::left << "Device" << std::setw(7) << "State" << std::setw(8) << "Queued" << std::setw(10) << "Peak"
+        << std::setw(10) << "Served" << std::setw(13) << "AvgWait(ms)" << std::setw(16) << "AvgService(ms)" << "Busy%\n";
+    for (int i = 0; i < count(); ++i) {
+        Device& device = *devices[i];
+        std::lock_guard<ProfiledMutex> lock(device.mutex);
+        long long busyNs = device.busyNs;
+        if (device.busy) busyNs += elapsedNs(device.serviceStart);
+        long long served = device.served;
+        long long started = served + (device.busy ? 1 : 0);
+
+        out << std::setw(8) << i << std::setw(7) << (device.busy ? "busy" : "idle") << std::setw(8) << device.requests.size()
+            << std::setw(10) << device.peakQueued << std::setw(10) << served
+            << std::setprecision(2)
+            << std::setw(13) << (started ? device.waitNs / 1e6 / started : 0.0)
+            << std::setw(16) << (served ? device.busyNs / 1e6 / served : 0.0)
+            << std::setprecision(1) << 100.0 * busyNs / elapsed << "\n";
+    }
+    out.unsetf(std::ios::fixed);
+    out << std::right;
+}
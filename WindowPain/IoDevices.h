@@ -0,0 +1,92 @@
+#ifndef IODEVICES_H
+#define IODEVICES_H
+
+#include "Config.h"
+#include "Utils.h"
+#include "Pool.h"
+#include "Profiler.h"
+#include <deque>
+#include <vector>
+#include <thread>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <functional>
+#include <condition_variable>
+#include <ostream>
+
+class Screen;
+
+enum class ServiceDistribution { Fixed, Uniform, Exponential };
+
+// Emulated I/O devices. An I/O-bound process issues an I/O instruction after every
+// io-interval print instructions; the instruction queues a request at the process's
+// device and the process leaves its core Blocked. Each device serves its queue in arrival
+// order on a thread of its own, holding every request for a service time drawn from the
+// io-service distribution, and then raises a completion that hands the process back to
+// the ready queue, so cores keep running other processes while the device works.
+class IoDevices {
+private:
+    struct Request {
+        Screen* screen;
+        std::chrono::steady_clock::time_point queued;
+    };
+    typedef std::deque<Request, PoolAllocator<Request>> Requests;
+
+    struct Device {
+        NodePool requestBlocks;
+        Requests requests;                      // waiting, not the one being served
+        ProfiledMutex mutex{ LockSite::Device };
+        std::condition_variable_any arrived;
+        std::thread thread;
+        std::mt19937 generator;                 // service times, used by the device thread only
+
+        std::atomic<bool> busy{ false };        // serving a request
+        std::chrono::steady_clock::time_point serviceStart;     // guarded by mutex
+        long long served = 0;                   // guarded by mutex from here on
+        long long busyNs = 0;                   // completed services
+        long long waitNs = 0;                   // time requests spent queued
+        size_t peakQueued = 0;
+
+        explicit Device(std::seed_seq& seed) : requests(Requests::allocator_type(&requestBlocks)), generator(seed) {}
+    };
+
+    int ioInterval;
+    int boundPercent;
+    double meanServiceMs;
+    ServiceDistribution distribution;
+    std::function<void(Screen&)> complete;      // completion interrupt: back to the ready queue
+    std::vector<std::unique_ptr<Device>> devices;
+    std::atomic<bool> stopping{ false };
+    std::chrono::steady_clock::time_point origin;
+
+    // Sampled every tick, for how much CPU and I/O overlapped
+    std::atomic<long long> sampledTicks{ 0 };
+    std::atomic<long long> deviceBusyTicks{ 0 };    // at least one device busy
+    std::atomic<long long> overlapTicks{ 0 };       // a device and a core busy
+
+    void serve(int deviceId);
+    std::chrono::microseconds serviceTime(std::mt19937& generator) const;
+
+public:
+    IoDevices(const Config& config, std::function<void(Screen&)> complete);
+    ~IoDevices();
+    IoDevices(const IoDevices&) = delete;
+    IoDevices& operator=(const IoDevices&) = delete;
+
+    bool enabled() const { return !devices.empty(); }
+    int count() const { return static_cast<int>(devices.size()); }
+    void assign(Screen& screen) const;          // make a new process I/O-bound or not, by its pid
+    void submit(Screen& screen);                // queue a request; the process must be off-core and Blocked
+    void start();
+    void stop();                                // stop serving; queued processes stay Blocked
+    void sample(bool coreBusy);                 // from the tick thread
+    int busyCount() const;
+    size_t queuedCount() const;
+    void printUtilization(std::ostream& out) const;
+
+    static bool parseDistribution(const String& value, ServiceDistribution& distribution);
+};
+
+#endif // IODEVICES_H
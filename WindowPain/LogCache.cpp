@@ -0,0 +1,150 @@
+#include "LogCache.h"
+
+#include <vector>
+
+LogCache::LogCache(size_t capacity)
+    : buffers(bufferBytes, 8), lru(Lru::allocator_type(&lruNodes)), open(Index::allocator_type(&indexNodes)),
+    capacity(capacity > 0 ? capacity : 1) {
+    open.reserve(this->capacity);
+}
+
+LogCache::~LogCache() {
+    for (auto& handle : lru) {
+        fclose(handle.file);
+    }
+}
+
+// The buffer must outlive the file, so it is only handed back once the file is closed
+FILE* LogCache::openFile(const String& path, bool truncate, char* buffer) {
+    FILE* file = nullptr;
+#ifdef _WIN32
+    if (fopen_s(&file, path.c_str(), truncate ? "w" : "a") != 0) {
+        file = nullptr;
+    }
+#else
+    file = fopen(path.c_str(), truncate ? "w" : "a");
+#endif
+    if (file) {
+        setvbuf(file, buffer, _IOFBF, bufferBytes);
+    }
+    return file;
+}
+
+FILE* LogCache::acquire(const NameEntry& entry, bool truncate) {
+    FILE* evicted = nullptr;
+    char* buffer = nullptr;
+    {
+        std::lock_guard<ProfiledMutex> lock(cacheMutex);
+        auto it = open.find(entry.pid);
+        if (it != open.end() && !truncate) {
+            hits++;
+            lru.splice(lru.begin(), lru, it->second);
+            it->second->pins++;
+            return it->second->file;
+        }
+        misses++;
+
+        if (it != open.end()) {
+            // Reopening to truncate: drop the old handle first
+            evicted = it->second->file;
+            buffer = it->second->buffer;
+            lru.erase(it->second);
+            open.erase(it);
+        }
+        else if (open.size() >= capacity) {
+            // Evict the least recently used handle nobody is writing to
+            for (auto victim = lru.rbegin(); victim != lru.rend(); ++victim) {
+                if (victim->pins == 0) {
+                    evicted = victim->file;
+                    buffer = victim->buffer;
+                    open.erase(victim->pid);
+                    lru.erase(std::next(victim).base());
+                    break;
+                }
+            }
+        }
+        if (!buffer) {
+            buffer = static_cast<char*>(buffers.allocate());
+        }
+    }
+
+    // The new file takes over the buffer of the one it replaces
+    if (evicted) fclose(evicted);
+
+    // Only the core running this process opens its file, so no one else can race us here
+    FILE* file = openFile(entry.logPath, truncate, buffer);
+
+    std::lock_guard<ProfiledMutex> lock(cacheMutex);
+    if (!file) {
+        buffers.deallocate(buffer);
+        return nullptr;
+    }
+    lru.push_front({ entry.pid, file, buffer, 1 });
+    open[entry.pid] = lru.begin();
+    return file;
+}
+
+void LogCache::release(int pid) {
+    std::lock_guard<ProfiledMutex> lock(cacheMutex);
+    auto it = open.find(pid);
+    if (it == open.end()) return;
+
+    fflush(it->second->file);
+    it->second->pins--;
+}
+
+// A process moving to another shard continues its log there, so our buffered handle
+// must not outlive it
+void LogCache::close(int pid) {
+    FILE* file = nullptr;
+    char* buffer = nullptr;
+    {
+        std::lock_guard<ProfiledMutex> lock(cacheMutex);
+        auto it = open.find(pid);
+        if (it == open.end() || it->second->pins > 0) return;
+
+        file = it->second->file;
+        buffer = it->second->buffer;
+        lru.erase(it->second);
+        open.erase(it);
+    }
+    fclose(file);
+
+    std::lock_guard<ProfiledMutex> lock(cacheMutex);
+    buffers.deallocate(buffer);
+}
+
+void LogCache::closeAll() {
+    std::vector<Handle> closing;
+    {
+        std::lock_guard<ProfiledMutex> lock(cacheMutex);
+        for (auto it = lru.begin(); it != lru.end();) {
+            if (it->pins == 0) {
+                closing.push_back(*it);
+                open.erase(it->pid);
+                it = lru.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+    for (const Handle& handle : closing) {
+        fclose(handle.file);
+    }
+
+    std::lock_guard<ProfiledMutex> lock(cacheMutex);
+    for (const Handle& handle : closing) {
+        buffers.deallocate(handle.buffer);
+    }
+}
+
+size_t LogCache::buffersInUse() {
+    std::lock_guard<ProfiledMutex> lock(cacheMutex);
+    return buffers.inUse();
+}
+
+size_t LogCache::buffersPooled() {
+    std::lock_guard<ProfiledMutex> lock(cacheMutex);
+    return buffers.capacity();
+}
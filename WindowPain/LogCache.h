@@ -0,0 +1,60 @@
+#ifndef LOGCACHE_H
+#define LOGCACHE_H
+
+#include "NameTable.h"
+#include "Pool.h"
+#include "Profiler.h"
+#include <cstdio>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+
+// LRU cache of open per-process log files shared by all cores. A process holds its
+// handle pinned while it runs, so eviction only closes files of processes off-core,
+// and an RR requeue finds its file still open on the next dispatch. Cache entries and
+// the stdio buffers of the files come from pools, so evicting one file to open another
+// reuses memory instead of allocating.
+class LogCache {
+private:
+    struct Handle {
+        int pid;
+        FILE* file;
+        char* buffer;   // stdio buffer of file, from buffers
+        int pins;
+    };
+
+    typedef std::list<Handle, PoolAllocator<Handle>> Lru;
+    typedef std::unordered_map<int, Lru::iterator, std::hash<int>, std::equal_to<int>,
+        PoolAllocator<std::pair<const int, Lru::iterator>>> Index;
+
+    static const size_t bufferBytes = 8192;
+
+    NodePool lruNodes;
+    NodePool indexNodes;
+    FixedPool buffers;
+    Lru lru;                    // most recently used first
+    Index open;                 // pid -> handle
+    size_t capacity;
+    ProfiledMutex cacheMutex{ LockSite::LogCache };   // also guards the pools
+
+    std::atomic<long long> hits{ 0 };
+    std::atomic<long long> misses{ 0 };
+
+    static FILE* openFile(const String& path, bool truncate, char* buffer);
+
+public:
+    explicit LogCache(size_t capacity);
+    ~LogCache();
+    FILE* acquire(const NameEntry& entry, bool truncate);   // pinned handle, or null if the file can't be opened
+    void release(int pid);                                  // flush and unpin
+    void close(int pid);                                    // close the handle of a process that left, if unpinned
+    void closeAll();                                        // close every unpinned handle
+    long long hitCount() const { return hits; }
+    long long missCount() const { return misses; }
+    size_t buffersInUse();
+    size_t buffersPooled();
+    static size_t bufferSize() { return bufferBytes; }
+};
+
+#endif // LOGCACHE_H
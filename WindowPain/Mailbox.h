@@ -0,0 +1,54 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include "SpscRing.h"
+#include <atomic>
+#include <chrono>
+
+class Screen;
+
+// One message slot of a mailbox, written and read in place
+struct Message {
+    int sequence;           // 1-based SEND number of the sender
+    int senderPid;
+    long long sentNs;       // when it was published, for delivery latency
+    char payload[40];
+};
+
+// Where the receiver of a mailbox is. SEND and the receiver's core agree through this
+// state on who puts a blocked receiver back in the ready queue, so a wakeup is never
+// lost and never delivered twice.
+enum class WaiterState : int {
+    Idle,       // receiver is not waiting
+    Blocking,   // receiver found the mailbox empty and is leaving its core
+    Parked,     // receiver is off-core and blocked; the next SEND requeues it
+    Woken       // a SEND arrived while Blocking; the receiver's core requeues it
+};
+
+// Pipe from one sender process to one receiver process. Each side is a single process,
+// which runs on one core at a time, so the ring has exactly one producer and one consumer.
+struct Mailbox {
+    SpscRing<Message> ring;
+    std::atomic<int> waiter{ static_cast<int>(WaiterState::Idle) };
+    Screen* sender = nullptr;
+    Screen* receiver = nullptr;
+    std::chrono::steady_clock::time_point blockedAt;    // set before the receiver parks
+
+    explicit Mailbox(size_t slots) : ring(slots) {}
+};
+
+// Message passing counters kept by the scheduler
+struct IpcStats {
+    std::atomic<long long> sent{ 0 };
+    std::atomic<long long> received{ 0 };
+    std::atomic<long long> sendStalls{ 0 };         // SENDs that found the mailbox full
+    std::atomic<long long> blocks{ 0 };             // RECVs that blocked the receiver
+    std::atomic<long long> parked{ 0 };             // receivers waiting for a SEND right now
+    std::atomic<long long> blockedNs{ 0 };          // time receivers spent blocked
+    std::atomic<long long> maxBlockedNs{ 0 };
+    std::atomic<long long> deliveryNs{ 0 };         // total SEND to RECV latency
+    std::atomic<long long> firstSendNs{ -1 };       // since the scheduler started
+    std::atomic<long long> lastReceiveNs{ 0 };
+};
+
+#endif // MAILBOX_H
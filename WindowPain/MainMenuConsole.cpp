@@ -3,6 +3,7 @@
 #include "ScreenManager.h"
 #include "Screen.h"
 #include "Utils.h"
+#include "Benchmark.h"
 
 #include <fstream>
 #include <iostream>
@@ -15,16 +16,44 @@ MainMenuConsole::MainMenuConsole(ScreenManager& sm, ConsoleManager& cm)
     commandMap["initialize"] = [this]() { initialize(); };
     commandMap["screen"] = [this]() { screen(); };
     commandMapWithArgs["screen -s"] = [this](const String& args) {
-        screenManager.screenCreate(args, "screenCreate");
+        String name;
+        int nice = 0;
+        if (screenManager.parseCreateOptions(args, name, nice)) {
+            screenManager.screenCreate(name, "screenCreate", nice);
+        }
         if (screenManager.currentScreen != "") {
             consoleManager.switchConsole(ConsoleType::Screen);
         }
     };
+    commandMapWithArgs["screen -s-batch"] = [this](const String& args) { screenManager.screenCreateBatch(args); };
     commandMapWithArgs["screen -r"] = [this](const String& args) { screenManager.screenRestore(args); };
     commandMap["screen -ls"] = [this]() { screenManager.screenList("screenList"); };
+    commandMapWithArgs["screen -ls"] = [this](const String& args) {
+        ProcessQuery query;
+        if (screenManager.parseListOptions(args, query)) {
+            screenManager.screenList("screenList", query);
+        }
+    };
     commandMap["scheduler-test"] = [this]() { schedulerTest(); };
     commandMap["scheduler-stop"] = [this]() { schedulerStop(); };
     commandMap["report-util"] = [this]() { reportUtil(); };
+    commandMapWithArgs["report-util"] = [this](const String& args) {
+        if (args == "--append") {
+            screenManager.reportChanges();
+        }
+        else {
+            printInColor("Usage: report-util [--append]\n\n", "red");
+        }
+    };
+    commandMap["core-stat"] = [this]() { screenManager.coreStat(); };
+    commandMap["memory-stat"] = [this]() { screenManager.memoryStat(); };
+    commandMap["ipc-stat"] = [this]() { screenManager.ipcStat(); };
+    commandMap["admission-stat"] = [this]() { screenManager.admissionStat(); };
+    commandMap["alloc-stat"] = [this]() { screenManager.allocStat(); };
+    commandMap["profile-dump"] = [this]() { screenManager.profileDump(); };
+    commandMapWithArgs["ipc-test"] = [this](const String& args) { screenManager.ipcTest(args); };
+    commandMapWithArgs["trace-export"] = [this](const String& args) { screenManager.traceExport(args); };
+    commandMapWithArgs["benchmark"] = [this](const String& args) { runBenchmark(args); };
     commandMap["clear"] = [this]() { clear(); };
     commandMap["exit"] = [this]() { exitProgram(); };
 }
@@ -83,7 +112,25 @@ void MainMenuConsole::help() {
     std::cout << "\n";
     printInColor("scheduler-stop", "green");
     std::cout << "\n";
-    printInColor("report-util", "green");
+    printInColor("report-util [--append]", "green");
+    std::cout << "\n";
+    printInColor("core-stat", "green");
+    std::cout << "\n";
+    printInColor("memory-stat", "green");
+    std::cout << "\n";
+    printInColor("ipc-test <pairs> [messages]", "green");
+    std::cout << "\n";
+    printInColor("ipc-stat", "green");
+    std::cout << "\n";
+    printInColor("admission-stat", "green");
+    std::cout << "\n";
+    printInColor("alloc-stat", "green");
+    std::cout << "\n";
+    printInColor("profile-dump", "green");
+    std::cout << "\n";
+    printInColor("trace-export <file>", "green");
+    std::cout << "\n";
+    printInColor("benchmark <name>", "green");
     std::cout << "\n";
     printInColor("clear", "green");
     std::cout << "\n";
@@ -95,12 +142,17 @@ void MainMenuConsole::help() {
 void MainMenuConsole::screen() {
     std::cout << "\n";
     std::cout << "'screen' commands:\n";
-    printInColor("screen -s <name>", "green");
+    printInColor("screen -s <name> [--nice N]", "green");
     std::cout << "\t(create a new screen)\n";
+    printInColor("screen -s-batch <prefix> <count> [min max]", "green");
+    std::cout << "\n\t\t\t(create <prefix>0 .. <prefix><count-1> at once, with min to max instructions)\n";
     printInColor("screen -r <name>", "green");
     std::cout << "\t(restore an existing screen)\n";
     printInColor("screen -ls", "green");
     std::cout << "\t\t(list all screens)\n";
+    printInColor("screen -ls [options]", "green");
+    std::cout << "\t(filter the list: --state ready|running|blocked|finished|all, --prefix <name>,\n";
+    std::cout << "\t\t\t --core <id>, --sort progress|age, --top <n>, --page <n>, --page-size <n>)\n";
     std::cout << "\n";
 }
 
@@ -110,7 +162,10 @@ void MainMenuConsole::initialize() {
 }
 
 void MainMenuConsole::reportUtil() {
-    screenManager.screenList("reportUtil");
+    // The report file always holds every process
+    ProcessQuery query;
+    query.pageSize = 0;
+    screenManager.screenList("reportUtil", query);
 }
 
 void MainMenuConsole::schedulerTest() {
@@ -126,6 +181,7 @@ void MainMenuConsole::clear() {
 }
 
 void MainMenuConsole::exitProgram() {
+    screenManager.shutdown();
     printInColor("Toodles!", "yellow");
     std::cout << "\n";
     exit(0);
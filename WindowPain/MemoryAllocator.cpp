@@ -0,0 +1,223 @@
+#include "MemoryAllocator.h"
+
+#include <algorithm>
+
+using std::max;
+using std::min;
+
+std::unique_ptr<MemoryAllocator> MemoryAllocator::create(AllocatorType type, int capacity) {
+    switch (type) {
+    case AllocatorType::BestFit:
+        return std::unique_ptr<MemoryAllocator>(new BestFitAllocator(capacity));
+    case AllocatorType::NextFit:
+        return std::unique_ptr<MemoryAllocator>(new NextFitAllocator(capacity));
+    case AllocatorType::Buddy:
+        return std::unique_ptr<MemoryAllocator>(new BuddyAllocator(capacity));
+    case AllocatorType::FirstFit:
+    default:
+        return std::unique_ptr<MemoryAllocator>(new FirstFitAllocator(capacity));
+    }
+}
+
+bool MemoryAllocator::parseType(const String& value, AllocatorType& type) {
+    if (value == "first-fit") type = AllocatorType::FirstFit;
+    else if (value == "best-fit") type = AllocatorType::BestFit;
+    else if (value == "next-fit") type = AllocatorType::NextFit;
+    else if (value == "buddy") type = AllocatorType::Buddy;
+    else return false;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Free list strategies
+
+FreeListAllocator::FreeListAllocator(int capacity) : totalSize(capacity) {
+    blocks[0] = { capacity, true, "" };
+}
+
+int FreeListAllocator::allocate(const String& owner, int size) {
+    if (size <= 0) return -1;
+
+    auto it = findBlock(size);
+    if (it == blocks.end()) return -1;
+
+    int address = it->first;
+    int remaining = it->second.size - size;
+    it->second = { size, false, owner };
+    if (remaining > 0) {
+        blocks[address + size] = { remaining, true, "" };
+    }
+
+    used += size;
+    processes++;
+    return address;
+}
+
+void FreeListAllocator::release(int address) {
+    auto it = blocks.find(address);
+    if (it == blocks.end() || it->second.free) return;
+
+    used -= it->second.size;
+    processes--;
+    it->second.free = true;
+    it->second.owner.clear();
+
+    // Coalesce with the following block
+    auto next = std::next(it);
+    if (next != blocks.end() && next->second.free) {
+        it->second.size += next->second.size;
+        blocks.erase(next);
+    }
+
+    // Coalesce with the preceding block
+    if (it != blocks.begin()) {
+        auto prev = std::prev(it);
+        if (prev->second.free) {
+            prev->second.size += it->second.size;
+            blocks.erase(it);
+        }
+    }
+}
+
+void FreeListAllocator::reset() {
+    blocks.clear();
+    blocks[0] = { totalSize, true, "" };
+    used = 0;
+    processes = 0;
+}
+
+int FreeListAllocator::largestFreeBlock() const {
+    int largest = 0;
+    for (const auto& block : blocks) {
+        if (block.second.free) largest = max(largest, block.second.size);
+    }
+    return largest;
+}
+
+void FreeListAllocator::printMap(std::ostream& out) const {
+    for (auto it = blocks.rbegin(); it != blocks.rend(); ++it) {
+        if (it->second.free) continue;
+        out << it->first + it->second.size << "\n";
+        out << it->second.owner << "\n";
+        out << it->first << "\n\n";
+    }
+}
+
+std::map<int, FreeListAllocator::Block>::iterator FirstFitAllocator::findBlock(int size) {
+    for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+        if (it->second.free && it->second.size >= size) return it;
+    }
+    return blocks.end();
+}
+
+std::map<int, FreeListAllocator::Block>::iterator BestFitAllocator::findBlock(int size) {
+    auto best = blocks.end();
+    for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+        if (it->second.free && it->second.size >= size &&
+            (best == blocks.end() || it->second.size < best->second.size)) {
+            best = it;
+            if (best->second.size == size) break;
+        }
+    }
+    return best;
+}
+
+std::map<int, FreeListAllocator::Block>::iterator NextFitAllocator::findBlock(int size) {
+    // Resume at the block containing the cursor, then wrap around once
+    auto start = blocks.upper_bound(cursor);
+    if (start != blocks.begin()) --start;
+
+    auto it = start;
+    do {
+        if (it->second.free && it->second.size >= size) {
+            cursor = it->first + size;
+            return it;
+        }
+        if (++it == blocks.end()) it = blocks.begin();
+    } while (it != start);
+
+    return blocks.end();
+}
+
+void NextFitAllocator::reset() {
+    FreeListAllocator::reset();
+    cursor = 0;
+}
+
+// ---------------------------------------------------------------------------
+// Buddy system
+
+BuddyAllocator::BuddyAllocator(int capacity) : maxOrder(minOrder) {
+    while (maxOrder < 30 && (1 << (maxOrder + 1)) <= capacity) {
+        maxOrder++;
+    }
+    freeLists.resize(maxOrder + 1);
+    freeLists[maxOrder].insert(0);
+}
+
+int BuddyAllocator::allocate(const String& owner, int size) {
+    if (size <= 0 || size > (1 << maxOrder)) return -1;
+
+    int order = minOrder;
+    while ((1 << order) < size) order++;
+
+    // Smallest free block that is large enough
+    int found = order;
+    while (found <= maxOrder && freeLists[found].empty()) found++;
+    if (found > maxOrder) return -1;
+
+    int address = *freeLists[found].begin();
+    freeLists[found].erase(freeLists[found].begin());
+
+    // Split down to the requested order, keeping the lower half
+    while (found > order) {
+        found--;
+        freeLists[found].insert(address + (1 << found));
+    }
+
+    allocated[address] = { order, owner };
+    used += 1 << order;
+    return address;
+}
+
+void BuddyAllocator::release(int address) {
+    auto it = allocated.find(address);
+    if (it == allocated.end()) return;
+
+    int order = it->second.first;
+    used -= 1 << order;
+    allocated.erase(it);
+
+    // Merge with the buddy while it is free
+    while (order < maxOrder) {
+        int buddy = address ^ (1 << order);
+        auto free = freeLists[order].find(buddy);
+        if (free == freeLists[order].end()) break;
+        freeLists[order].erase(free);
+        address = min(address, buddy);
+        order++;
+    }
+    freeLists[order].insert(address);
+}
+
+void BuddyAllocator::reset() {
+    for (auto& list : freeLists) list.clear();
+    freeLists[maxOrder].insert(0);
+    allocated.clear();
+    used = 0;
+}
+
+int BuddyAllocator::largestFreeBlock() const {
+    for (int order = maxOrder; order >= minOrder; --order) {
+        if (!freeLists[order].empty()) return 1 << order;
+    }
+    return 0;
+}
+
+void BuddyAllocator::printMap(std::ostream& out) const {
+    for (auto it = allocated.rbegin(); it != allocated.rend(); ++it) {
+        out << it->first + (1 << it->second.first) << "\n";
+        out << it->second.second << "\n";
+        out << it->first << "\n\n";
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef MEMORYALLOCATOR_H
+#define MEMORYALLOCATOR_H
+
+#include "Utils.h"
+#include <map>
+#include <set>
+#include <vector>
+#include <memory>
+#include <ostream>
+
+enum class AllocatorType { FirstFit, BestFit, NextFit, Buddy };
+
+// Strategy for placing processes in the flat emulated memory
+class MemoryAllocator {
+public:
+    virtual ~MemoryAllocator() = default;
+    virtual int allocate(const String& owner, int size) = 0;   // base address, or -1 if it does not fit
+    virtual void release(int address) = 0;
+    virtual void reset() = 0;                                   // free everything
+    virtual int capacity() const = 0;
+    virtual int usedBytes() const = 0;
+    virtual int largestFreeBlock() const = 0;
+    virtual int processCount() const = 0;
+    virtual void printMap(std::ostream& out) const = 0;         // highest address first
+    virtual const char* name() const = 0;
+
+    static std::unique_ptr<MemoryAllocator> create(AllocatorType type, int capacity);
+    static bool parseType(const String& value, AllocatorType& type);
+};
+
+// Address-ordered block list shared by the first-fit, best-fit and next-fit strategies
+class FreeListAllocator : public MemoryAllocator {
+protected:
+    struct Block {
+        int size;
+        bool free;
+        String owner;
+    };
+
+    std::map<int, Block> blocks;    // base address -> block, free and used
+    int totalSize;
+    int used = 0;
+    int processes = 0;
+
+    virtual std::map<int, Block>::iterator findBlock(int size) = 0;  // free block to carve from
+
+public:
+    explicit FreeListAllocator(int capacity);
+    int allocate(const String& owner, int size) override;
+    void release(int address) override;
+    void reset() override;
+    int capacity() const override { return totalSize; }
+    int usedBytes() const override { return used; }
+    int largestFreeBlock() const override;
+    int processCount() const override { return processes; }
+    void printMap(std::ostream& out) const override;
+};
+
+class FirstFitAllocator : public FreeListAllocator {
+protected:
+    std::map<int, Block>::iterator findBlock(int size) override;
+public:
+    using FreeListAllocator::FreeListAllocator;
+    const char* name() const override { return "first-fit"; }
+};
+
+class BestFitAllocator : public FreeListAllocator {
+protected:
+    std::map<int, Block>::iterator findBlock(int size) override;
+public:
+    using FreeListAllocator::FreeListAllocator;
+    const char* name() const override { return "best-fit"; }
+};
+
+class NextFitAllocator : public FreeListAllocator {
+private:
+    int cursor = 0;     // address where the previous search stopped
+protected:
+    std::map<int, Block>::iterator findBlock(int size) override;
+public:
+    using FreeListAllocator::FreeListAllocator;
+    void reset() override;
+    const char* name() const override { return "next-fit"; }
+};
+
+// Binary buddy system over the largest power of two that fits the configured memory
+class BuddyAllocator : public MemoryAllocator {
+public:
+    static const int minOrder = 4;          // smallest block is 16 bytes, so less memory cannot be managed
+
+private:
+    int maxOrder;
+    std::vector<std::set<int>> freeLists;   // free block addresses per order
+    std::map<int, std::pair<int, String>> allocated;  // address -> (order, owner)
+    int used = 0;
+
+public:
+    explicit BuddyAllocator(int capacity);
+    int allocate(const String& owner, int size) override;
+    void release(int address) override;
+    void reset() override;
+    int capacity() const override { return 1 << maxOrder; }
+    int usedBytes() const override { return used; }
+    int largestFreeBlock() const override;
+    int processCount() const override { return static_cast<int>(allocated.size()); }
+    void printMap(std::ostream& out) const override;
+    const char* name() const override { return "buddy"; }
+};
+
+#endif // MEMORYALLOCATOR_H
@@ -0,0 +1,161 @@
+#include "MemoryManager.h"
+#include "Screen.h"
+#include "Utils.h"
+
+#include <fstream>
+#include <chrono>
+#include <ctime>
+#include <algorithm>
+
+using std::max;
+
+MemoryManager::MemoryManager(const Config& config) : memPerIns(config.mem_per_ins) {
+    if (config.max_overall_mem > 0) {
+        AllocatorType type = AllocatorType::FirstFit;
+        MemoryAllocator::parseType(config.memory_allocator, type);
+        allocator = MemoryAllocator::create(type, config.max_overall_mem);
+    }
+}
+
+bool MemoryManager::enabled() const {
+    return allocator != nullptr;
+}
+
+// Caller holds memoryMutex
+bool MemoryManager::tryAllocate(Screen& screen) {
+    auto start = std::chrono::steady_clock::now();
+    int address = allocator->allocate(screen.getName(), screen.memorySize);
+    long long elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    attempts++;
+    totalLatencyNs += elapsed;
+    maxLatencyNs = max(maxLatencyNs, elapsed);
+    if (address < 0) return false;
+
+    allocations++;
+    screen.memoryBase = address;
+    return true;
+}
+
+Placement MemoryManager::place(Screen& screen) {
+    if (!allocator) return Placement::Placed;
+
+    std::lock_guard<ProfiledMutex> lock(memoryMutex);
+    long long size = static_cast<long long>(max(1, screen.totalLines)) * memPerIns;   // overflows int for large mem-per-ins
+
+    if (size > allocator->capacity()) {
+        rejected++;
+        return Placement::Rejected;
+    }
+    screen.memorySize = static_cast<int>(size);
+    if (tryAllocate(screen)) {
+        return Placement::Placed;
+    }
+
+    deferred++;
+    backlog.push_back(&screen);
+    return Placement::Deferred;
+}
+
+// Waiting processes are admitted in arrival order, skipping any that still do not fit
+void MemoryManager::release(Screen& screen, ScratchVector<Screen*>& admitted) {
+    if (!allocator) return;
+
+    std::lock_guard<ProfiledMutex> lock(memoryMutex);
+    if (screen.memoryBase < 0) return;
+
+    allocator->release(screen.memoryBase);
+    screen.memoryBase = -1;
+
+    for (auto it = backlog.begin(); it != backlog.end();) {
+        if (tryAllocate(**it)) {
+            admitted.push_back(*it);
+            it = backlog.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+// Removes a process from the backlog. Returns false if it is not waiting there: it
+// already holds memory or has not been placed yet, and belongs to the scheduler.
+bool MemoryManager::cancel(Screen& screen) {
+    if (!allocator) return false;
+
+    std::lock_guard<ProfiledMutex> lock(memoryMutex);
+    auto it = std::find(backlog.begin(), backlog.end(), &screen);
+    if (it == backlog.end()) return false;
+
+    backlog.erase(it);
+    return true;
+}
+
+double MemoryManager::fragmentationLocked() const {
+    int free = allocator->capacity() - allocator->usedBytes();
+    if (free <= 0) return 0.0;
+    return 100.0 * (free - allocator->largestFreeBlock()) / free;
+}
+
+size_t MemoryManager::backlogSize() const {
+    std::lock_guard<ProfiledMutex> lock(memoryMutex);
+    return backlog.size();
+}
+
+double MemoryManager::externalFragmentation() const {
+    if (!allocator) return 0.0;
+
+    std::lock_guard<ProfiledMutex> lock(memoryMutex);
+    return fragmentationLocked();
+}
+
+void MemoryManager::writeSnapshot(long long quantum) const {
+    if (!allocator) return;
+
+    time_t now = time(0);
+    tm ltm;
+#ifdef _WIN32
+    localtime_s(&ltm, &now);
+#else
+    localtime_r(&now, &ltm);
+#endif
+    char timestamp[25];
+    strftime(timestamp, sizeof(timestamp), "(%m/%d/%Y %I:%M:%S %p)", &ltm);
+
+    std::ofstream file("memory_stamp_" + std::to_string(quantum) + ".txt");
+    if (!file.is_open()) return;
+
+    std::lock_guard<ProfiledMutex> lock(memoryMutex);
+    int free = allocator->capacity() - allocator->usedBytes();
+    file << "Timestamp: " << timestamp << "\n";
+    file << "Allocator: " << allocator->name() << "\n";
+    file << "Number of processes in memory: " << allocator->processCount() << "\n";
+    file << "Processes waiting for memory: " << backlog.size() << "\n";
+    file << "Total external fragmentation in bytes: " << free - allocator->largestFreeBlock() << "\n\n";
+    file << "----end---- = " << allocator->capacity() << "\n\n";
+    allocator->printMap(file);
+    file << "----start---- = 0\n";
+}
+
+void MemoryManager::printStats(std::ostream& out) const {
+    if (!allocator) {
+        out << "\nMemory model disabled (set max-overall-mem in config.txt).\n\n";
+        return;
+    }
+
+    std::lock_guard<ProfiledMutex> lock(memoryMutex);
+    out << "\n---------------------------------------\n";
+    out << "Allocator: " << allocator->name() << "\n";
+    out << "Memory Used: " << allocator->usedBytes() << " / " << allocator->capacity() << "\n";
+    out << "Processes in Memory: " << allocator->processCount() << "\n";
+    out << "Largest Free Block: " << allocator->largestFreeBlock() << "\n";
+    out << "External Fragmentation: " << fragmentationLocked() << "%\n";
+    out << "Allocations: " << allocations << "\n";
+    out << "Avg Allocation Latency: " << (attempts ? totalLatencyNs / attempts : 0) << " ns\n";
+    out << "Max Allocation Latency: " << maxLatencyNs << " ns\n";
+    out << "Turned Away (deferred): " << deferred << "\n";
+    out << "Turned Away (too large): " << rejected << "\n";
+    out << "Waiting for Memory: " << backlog.size() << "\n";
+    out << "---------------------------------------\n\n";
+}
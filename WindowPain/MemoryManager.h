@@ -0,0 +1,49 @@
+#ifndef MEMORYMANAGER_H
+#define MEMORYMANAGER_H
+
+#include "Config.h"
+#include "MemoryAllocator.h"
+#include "Arena.h"
+#include "Profiler.h"
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <ostream>
+
+class Screen;
+
+enum class Placement { Placed, Deferred, Rejected };
+
+// Flat emulated memory shared by all processes. Processes that do not fit wait in a
+// backlog and are admitted as memory is released.
+class MemoryManager {
+private:
+    std::unique_ptr<MemoryAllocator> allocator;   // null when the memory model is disabled
+    std::deque<Screen*> backlog;                  // processes waiting for memory
+    mutable ProfiledMutex memoryMutex{ LockSite::Memory };
+    int memPerIns;
+
+    long long attempts = 0;
+    long long allocations = 0;
+    long long deferred = 0;                       // placements that had to wait in the backlog
+    long long rejected = 0;                       // processes larger than the whole memory
+    long long totalLatencyNs = 0;
+    long long maxLatencyNs = 0;
+
+    bool tryAllocate(Screen& screen);
+    double fragmentationLocked() const;
+
+public:
+    explicit MemoryManager(const Config& config);
+    bool enabled() const;
+    Placement place(Screen& screen);                            // allocate or park in the backlog
+    void release(Screen& screen, ScratchVector<Screen*>& admitted); // free and admit waiting processes
+    bool cancel(Screen& screen);                                // withdraw a process waiting in the backlog
+    size_t backlogSize() const;                                 // processes waiting for memory
+    double externalFragmentation() const;                       // free memory outside the largest hole, in %
+    void writeSnapshot(long long quantum) const;                // memory_stamp_<quantum>.txt
+    void printStats(std::ostream& out) const;
+};
+
+#endif // MEMORYMANAGER_H
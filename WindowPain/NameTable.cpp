@@ -0,0 +1,51 @@
+#include "NameTable.h"
+
+NameEntry NameTable::makeEntry(int pid, const String& name) {
+    return { pid, name, name + ".txt", "\"Hello world from " + name + "!\"\n" };
+}
+
+const NameEntry& NameTable::intern(const String& name) {
+    std::lock_guard<ProfiledMutex> lock(tableMutex);
+    auto it = ids.find(name);
+    if (it != ids.end()) {
+        return entries[it->second];
+    }
+
+    int pid = static_cast<int>(entries.size());
+    entries.push_back(makeEntry(pid, name));
+    ids.emplace(name, pid);
+    return entries.back();
+}
+
+// Interns entries whose strings were built by the caller, under one lock. Names already
+// in the table keep their entry; out gets the interned entry of every prepared one.
+void NameTable::internBatch(std::vector<NameEntry>& prepared, std::vector<const NameEntry*>& out) {
+    std::lock_guard<ProfiledMutex> lock(tableMutex);
+    ids.reserve(ids.size() + prepared.size());
+    out.resize(prepared.size());
+    for (size_t i = 0; i < prepared.size(); ++i) {
+        int pid = static_cast<int>(entries.size());
+        auto inserted = ids.emplace(prepared[i].name, pid);
+        if (inserted.second) {
+            prepared[i].pid = pid;
+            entries.push_back(std::move(prepared[i]));
+        }
+        out[i] = &entries[inserted.first->second];
+    }
+}
+
+int NameTable::find(const String& name) const {
+    std::lock_guard<ProfiledMutex> lock(tableMutex);
+    auto it = ids.find(name);
+    return it != ids.end() ? it->second : -1;
+}
+
+const NameEntry& NameTable::entry(int pid) const {
+    std::lock_guard<ProfiledMutex> lock(tableMutex);
+    return entries[pid];
+}
+
+size_t NameTable::size() const {
+    std::lock_guard<ProfiledMutex> lock(tableMutex);
+    return entries.size();
+}
@@ -0,0 +1,44 @@
+#ifndef NAMETABLE_H
+#define NAMETABLE_H
+
+#include "Utils.h"
+#include "Pool.h"
+#include "Profiler.h"
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <string>
+
+// Strings a process needs on hot paths, built once when its name is interned
+struct NameEntry {
+    int pid;
+    String name;
+    String logPath;     // "<name>.txt"
+    String message;     // "\"Hello world from <name>!\"\n"
+};
+
+// Interns process names: every distinct name gets a stable integer ID and a NameEntry
+// that lives as long as the table, so the scheduler never rebuilds these strings.
+class NameTable {
+private:
+    typedef std::unordered_map<String, int, std::hash<String>, std::equal_to<String>,
+        PoolAllocator<std::pair<const String, int>>> Ids;
+
+    std::deque<NameEntry> entries;              // indexed by pid; deque keeps references stable
+    NodePool idNodes;                           // nodes of ids
+    Ids ids;
+    mutable ProfiledMutex tableMutex{ LockSite::NameTable };
+
+public:
+    NameTable() : ids(0, Ids::hasher(), Ids::key_equal(), Ids::allocator_type(&idNodes)) {}
+    const NameEntry& intern(const String& name);    // existing or new entry
+    void internBatch(std::vector<NameEntry>& prepared, std::vector<const NameEntry*>& out);  // moves the new ones in
+    int find(const String& name) const;             // pid, or -1 if never interned
+    const NameEntry& entry(int pid) const;
+    size_t size() const;
+
+    static NameEntry makeEntry(int pid, const String& name);    // builds the strings
+};
+
+#endif // NAMETABLE_H
@@ -0,0 +1,159 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <new>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+// Free list of equally sized blocks carved from slabs. Slabs are only allocated while
+// the pool grows, each doubling the pool up to maxPerSlab blocks, and are kept until it
+// is destroyed, so once a workload has reached its peak every allocation is a pop and
+// every free a push. Not thread-safe: the owner's lock guards it.
+class FixedPool {
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    size_t blockSize = 0;
+    size_t maxPerSlab = 0;
+    FreeBlock* freeList = nullptr;
+    std::vector<void*> slabs;
+    size_t blocks = 0;
+    size_t used = 0;
+
+    static size_t roundUp(size_t size) {
+        const size_t align = alignof(std::max_align_t);
+        return (std::max(size, sizeof(FreeBlock)) + align - 1) / align * align;
+    }
+
+    void grow() {
+        size_t count = std::min(maxPerSlab, std::max<size_t>(blocks, 1));
+        char* slab = static_cast<char*>(::operator new(blockSize * count));
+        slabs.push_back(slab);
+        blocks += count;
+        for (size_t i = count; i > 0; --i) {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + (i - 1) * blockSize);
+            block->next = freeList;
+            freeList = block;
+        }
+    }
+
+public:
+    FixedPool() = default;
+    FixedPool(size_t size, size_t maxPerSlab) { init(size, maxPerSlab); }
+    ~FixedPool() {
+        for (void* slab : slabs) ::operator delete(slab);
+    }
+    FixedPool(const FixedPool&) = delete;
+    FixedPool& operator=(const FixedPool&) = delete;
+
+    // Sets the block size of an unused pool
+    void init(size_t size, size_t perSlab) {
+        blockSize = roundUp(size);
+        maxPerSlab = std::max<size_t>(perSlab, 1);
+    }
+
+    void* allocate() {
+        if (!freeList) grow();
+        FreeBlock* block = freeList;
+        freeList = block->next;
+        used++;
+        return block;
+    }
+
+    void deallocate(void* memory) {
+        FreeBlock* block = static_cast<FreeBlock*>(memory);
+        block->next = freeList;
+        freeList = block;
+        used--;
+    }
+
+    size_t blockBytes() const { return blockSize; }
+    size_t inUse() const { return used; }
+    size_t capacity() const { return blocks; }
+};
+
+// Fixed-size pools for one node-based container. A container asks for only a few sizes
+// (its nodes, perhaps bucket or map arrays), and each small size gets a FixedPool of its
+// own; larger requests and sizes beyond the first few go to the heap. Pools start with a
+// single block, so a size asked for once costs no more than the heap would.
+class NodePool {
+private:
+    static const size_t maxClasses = 4;
+    static const size_t maxBlock = 1024;
+    static const size_t slabBytes = 16384;
+
+    size_t sizes[maxClasses] = {};
+    FixedPool classes[maxClasses];
+    size_t classCount = 0;
+
+    FixedPool* find(size_t bytes) {
+        for (size_t i = 0; i < classCount; ++i) {
+            if (sizes[i] == bytes) return &classes[i];
+        }
+        return nullptr;
+    }
+
+public:
+    NodePool() = default;
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    void* allocate(size_t bytes) {
+        FixedPool* pool = find(bytes);
+        if (!pool && bytes <= maxBlock && classCount < maxClasses) {
+            sizes[classCount] = bytes;
+            pool = &classes[classCount++];
+            pool->init(bytes, slabBytes / bytes);
+        }
+        return pool ? pool->allocate() : ::operator new(bytes);
+    }
+
+    void deallocate(void* memory, size_t bytes) {
+        FixedPool* pool = find(bytes);
+        if (pool) {
+            pool->deallocate(memory);
+        }
+        else {
+            ::operator delete(memory);
+        }
+    }
+
+    size_t inUse() const {
+        size_t total = 0;
+        for (size_t i = 0; i < classCount; ++i) total += classes[i].inUse();
+        return total;
+    }
+
+    size_t capacity() const {
+        size_t total = 0;
+        for (size_t i = 0; i < classCount; ++i) total += classes[i].capacity();
+        return total;
+    }
+};
+
+// Standard allocator over a NodePool, for containers whose nodes should be recycled
+// instead of going back to the heap
+template <typename T>
+class PoolAllocator {
+public:
+    typedef T value_type;
+
+    NodePool* pool;
+
+    explicit PoolAllocator(NodePool* pool) : pool(pool) {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) : pool(other.pool) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(pool->allocate(n * sizeof(T))); }
+    void deallocate(T* memory, size_t n) { pool->deallocate(memory, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const { return pool == other.pool; }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>& other) const { return pool != other.pool; }
+};
+
+#endif // POOL_H
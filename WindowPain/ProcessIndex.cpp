@@ -0,0 +1,316 @@
+#include "ProcessIndex.h"
+#include "Screen.h"
+#include "Arena.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+ProcessIndex::ProcessIndex(int numCores) : coreLists(numCores), byName(NameIndex::allocator_type(&nameNodes)) {}
+
+// State lists are appended on every state change, so each one is ordered by stateChange
+void ProcessIndex::linkState(Screen* screen) {
+    screen->stateChange = ++changes;
+    List& list = stateLists[static_cast<int>(screen->state)];
+    screen->statePrev = list.tail;
+    screen->stateNext = nullptr;
+    if (list.tail) list.tail->stateNext = screen;
+    else list.head = screen;
+    list.tail = screen;
+    list.size++;
+}
+
+void ProcessIndex::unlinkState(Screen* screen) {
+    List& list = stateLists[static_cast<int>(screen->state)];
+    if (screen->statePrev) screen->statePrev->stateNext = screen->stateNext;
+    else list.head = screen->stateNext;
+    if (screen->stateNext) screen->stateNext->statePrev = screen->statePrev;
+    else list.tail = screen->statePrev;
+    screen->statePrev = screen->stateNext = nullptr;
+    list.size--;
+}
+
+void ProcessIndex::linkCore(Screen* screen, int coreId) {
+    List& list = coreLists[coreId];
+    screen->corePrev = list.tail;
+    screen->coreNext = nullptr;
+    if (list.tail) list.tail->coreNext = screen;
+    else list.head = screen;
+    list.tail = screen;
+    list.size++;
+    screen->indexedCore = coreId;
+}
+
+void ProcessIndex::unlinkCore(Screen* screen) {
+    List& list = coreLists[screen->indexedCore];
+    if (screen->corePrev) screen->corePrev->coreNext = screen->coreNext;
+    else list.head = screen->coreNext;
+    if (screen->coreNext) screen->coreNext->corePrev = screen->corePrev;
+    else list.tail = screen->corePrev;
+    screen->corePrev = screen->coreNext = nullptr;
+    screen->indexedCore = -1;
+    list.size--;
+}
+
+void ProcessIndex::add(Screen& screen) {
+    std::lock_guard<ProfiledMutex> lock(indexMutex);
+    screen.state = ProcessState::New;
+    screen.indexedCore = -1;
+    byName[screen.getName()] = &screen;
+    linkState(&screen);
+}
+
+// Consecutive names of a batch mostly sort next to each other, so each is inserted just
+// after the previous one when it belongs there
+void ProcessIndex::addBatch(Screen* const* screens, size_t count) {
+    std::lock_guard<ProfiledMutex> lock(indexMutex);
+    auto hint = byName.end();
+    for (size_t i = 0; i < count; ++i) {
+        Screen* screen = screens[i];
+        screen->state = ProcessState::New;
+        screen->indexedCore = -1;
+        auto it = byName.emplace_hint(hint, screen->getName(), screen);
+        it->second = screen;
+        hint = std::next(it);
+        linkState(screen);
+    }
+}
+
+void ProcessIndex::setState(Screen& screen, ProcessState state) {
+    std::lock_guard<ProfiledMutex> lock(indexMutex);
+    unlinkState(&screen);
+    screen.state = state;
+    linkState(&screen);
+}
+
+void ProcessIndex::setStateBatch(Screen* const* screens, size_t count, ProcessState state) {
+    std::lock_guard<ProfiledMutex> lock(indexMutex);
+    for (size_t i = 0; i < count; ++i) {
+        unlinkState(screens[i]);
+        screens[i]->state = state;
+        linkState(screens[i]);
+    }
+}
+
+void ProcessIndex::assignCore(Screen& screen, int coreId) {
+    std::lock_guard<ProfiledMutex> lock(indexMutex);
+    if (screen.indexedCore != -1) {
+        unlinkCore(&screen);
+    }
+    if (coreId >= 0 && coreId < static_cast<int>(coreLists.size())) {
+        linkCore(&screen, coreId);
+    }
+}
+
+void ProcessIndex::remove(Screen& screen) {
+    std::lock_guard<ProfiledMutex> lock(indexMutex);
+    if (screen.indexedCore != -1) {
+        unlinkCore(&screen);
+    }
+    unlinkState(&screen);
+
+    auto it = byName.find(screen.getName());
+    if (it != byName.end() && it->second == &screen) {
+        byName.erase(it);
+    }
+    removals++;
+}
+
+size_t ProcessIndex::count(ProcessState state) const {
+    std::lock_guard<ProfiledMutex> lock(indexMutex);
+    return stateLists[static_cast<int>(state)].size;
+}
+
+int ProcessIndex::busyCores() const {
+    std::lock_guard<ProfiledMutex> lock(indexMutex);
+    int busy = 0;
+    for (const auto& list : coreLists) {
+        if (list.size > 0) busy++;
+    }
+    return busy;
+}
+
+bool ProcessIndex::matches(const Screen* screen, const ProcessQuery& query, ProcessState state) const {
+    if (screen->state != state) return false;
+    if (query.core >= 0 && screen->indexedCore != query.core) return false;
+    if (!query.prefix.empty() && screen->getName().compare(0, query.prefix.size(), query.prefix) != 0) return false;
+    return true;
+}
+
+static ProcessRow makeRow(const Screen* screen) {
+    return { screen->getName(), screen->timestamp, screen->coreId, screen->currentLine, screen->totalLines, screen->state,
+        screen->stateChange };
+}
+
+static double progressOf(const Screen* screen) {
+    return screen->totalLines > 0 ? static_cast<double>(screen->currentLine) / screen->totalLines : 0.0;
+}
+
+static bool moreProgress(const Screen* a, const Screen* b) {
+    return progressOf(a) > progressOf(b);
+}
+
+// Offers a candidate to a heap of the window processes with the most progress (0 for no limit)
+static void keepBest(ScratchVector<const Screen*>& heap, size_t window, const Screen* screen) {
+    if (!window || heap.size() < window) {
+        heap.push_back(screen);
+        std::push_heap(heap.begin(), heap.end(), moreProgress);
+    }
+    else if (progressOf(screen) > progressOf(heap.front())) {
+        std::pop_heap(heap.begin(), heap.end(), moreProgress);
+        heap.back() = screen;
+        std::push_heap(heap.begin(), heap.end(), moreProgress);
+    }
+}
+
+// Walks the smallest index that can answer the query: a core list, the name range of
+// the prefix, or the state list (age order needs the state list). Only the rows up to
+// the requested page are visited, except when sorting by progress, which keeps a
+// bounded heap of the best candidates.
+void ProcessIndex::collect(const ProcessQuery& query, ProcessState state, ProcessPage& page) const {
+    size_t pageSize = query.pageSize > 0 ? static_cast<size_t>(query.pageSize) : 0;
+    size_t skip = pageSize ? (static_cast<size_t>(std::max(query.page, 1)) - 1) * pageSize : 0;
+    size_t limit = query.top > 0 ? static_cast<size_t>(query.top) : 0;
+
+    // Visit candidates in index order; stop when the visitor returns false
+    auto walk = [&](const std::function<bool(const Screen*)>& visit) {
+        if (query.core >= 0) {
+            if (query.core >= static_cast<int>(coreLists.size())) return;
+            for (const Screen* s = coreLists[query.core].head; s; s = s->coreNext) {
+                if (matches(s, query, state) && !visit(s)) return;
+            }
+        }
+        else if (!query.prefix.empty() && query.sort != ListSort::Age) {
+            for (auto it = byName.lower_bound(query.prefix); it != byName.end(); ++it) {
+                if (it->first.compare(0, query.prefix.size(), query.prefix) != 0) break;
+                if (matches(it->second, query, state) && !visit(it->second)) return;
+            }
+        }
+        else {
+            for (const Screen* s = stateLists[static_cast<int>(state)].head; s; s = s->stateNext) {
+                if (matches(s, query, state) && !visit(s)) return;
+            }
+        }
+    };
+
+    if (query.core < 0 && query.prefix.empty()) {
+        page.total = stateLists[static_cast<int>(state)].size;
+        if (limit) page.total = std::min(page.total, limit);
+    }
+
+    if (query.sort == ListSort::Progress) {
+        // Keep only the best (skip + pageSize + 1) candidates, capped by top
+        size_t window = pageSize ? skip + pageSize + 1 : 0;
+        if (limit && (!window || limit < window)) window = limit;
+        ArenaScope scratch;
+        ScratchVector<const Screen*> heap;
+        walk([&](const Screen* s) {
+            keepBest(heap, window, s);
+            return true;
+        });
+        std::sort_heap(heap.begin(), heap.end(), moreProgress);
+        size_t end = limit ? std::min(heap.size(), limit) : heap.size();
+        for (size_t i = skip; i < end && (!pageSize || page.rows.size() < pageSize); ++i) {
+            page.rows.push_back(makeRow(heap[i]));
+        }
+        page.hasMore = skip + page.rows.size() < end;
+        return;
+    }
+
+    // Unsorted and age order are both list order: lists are appended on every state change,
+    // so the head has been in its state the longest
+    size_t seen = 0;
+    walk([&](const Screen* s) {
+        if (limit && seen >= limit) return false;
+        if (seen++ < skip) return true;
+        if (pageSize && page.rows.size() >= pageSize) {
+            page.hasMore = true;
+            return false;
+        }
+        page.rows.push_back(makeRow(s));
+        return true;
+    });
+}
+
+ProcessPage ProcessIndex::page(const ProcessQuery& query, ProcessState state) const {
+    ProcessPage page;
+    std::lock_guard<ProfiledMutex> lock(indexMutex);
+    collect(query, state, page);
+    return page;
+}
+
+// Called with the lock held, so visit must not call back into the index. Nothing is
+// copied and the heap is scratch, so the status page can call this every tick.
+void ProcessIndex::top(ProcessState state, size_t count, const std::function<void(const Screen&)>& visit) const {
+    ArenaScope scratch;
+    ScratchVector<const Screen*> heap;
+    heap.reserve(count);
+
+    std::lock_guard<ProfiledMutex> lock(indexMutex);
+    for (const Screen* s = stateLists[static_cast<int>(state)].head; s; s = s->stateNext) {
+        keepBest(heap, count, s);
+    }
+    std::sort_heap(heap.begin(), heap.end(), moreProgress);
+    for (const Screen* s : heap) {
+        visit(*s);
+    }
+}
+
+// Copies the list a chunk at a time and calls emit without the lock, so a large listing
+// needs memory for one chunk and never stalls the scheduler while it is written out. The
+// last process copied marks where the next chunk starts. If processes were removed in
+// between it may be gone, and if it changed state it has moved to the tail of a list;
+// then the place is found again by change sequence, since the list is ordered by it.
+void ProcessIndex::scan(ProcessState state, const std::function<void(const ProcessRow&)>& emit) const {
+    std::vector<ProcessRow> chunk;
+    const Screen* cursor = nullptr;
+    uint64_t after = 0;
+    uint64_t removedBefore = 0;
+
+    for (;;) {
+        chunk.clear();
+        {
+            std::lock_guard<ProfiledMutex> lock(indexMutex);
+            const Screen* s = stateLists[static_cast<int>(state)].head;
+            if (cursor && removals == removedBefore && cursor->stateChange == after) {
+                s = cursor->stateNext;
+            }
+            else {
+                while (s && s->stateChange <= after) s = s->stateNext;
+            }
+            for (; s && chunk.size() < scanChunk; s = s->stateNext) {
+                chunk.push_back(makeRow(s));
+                cursor = s;
+                after = s->stateChange;
+            }
+            removedBefore = removals;
+        }
+        if (chunk.empty()) return;
+
+        for (const ProcessRow& row : chunk) {
+            emit(row);
+        }
+    }
+}
+
+uint64_t ProcessIndex::changeCount() const {
+    std::lock_guard<ProfiledMutex> lock(indexMutex);
+    return changes;
+}
+
+// Walks every state list back from its tail, where the latest changes are, so the cost is
+// the number of processes changed rather than the number indexed
+std::vector<ProcessRow> ProcessIndex::changedSince(uint64_t since, uint64_t& upTo) const {
+    std::vector<ProcessRow> rows;
+    {
+        std::lock_guard<ProfiledMutex> lock(indexMutex);
+        upTo = changes;
+        for (const List& list : stateLists) {
+            for (const Screen* s = list.tail; s && s->stateChange > since; s = s->statePrev) {
+                rows.push_back(makeRow(s));
+            }
+        }
+    }
+    std::sort(rows.begin(), rows.end(), [](const ProcessRow& a, const ProcessRow& b) { return a.change < b.change; });
+    return rows;
+}
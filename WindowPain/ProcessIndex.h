@@ -0,0 +1,94 @@
+#ifndef PROCESSINDEX_H
+#define PROCESSINDEX_H
+
+#include "Utils.h"
+#include "Screen.h"
+#include "Pool.h"
+#include "Profiler.h"
+#include <map>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <functional>
+
+// Which processes a listing should show
+enum class StateFilter { All, Ready, Running, Finished, Blocked };
+enum class ListSort { None, Progress, Age };
+
+// Options of a process listing (screen -ls / report-util)
+struct ProcessQuery {
+    StateFilter state = StateFilter::All;
+    String prefix;              // only names starting with this
+    int core = -1;              // only processes running on this core (-1 for any)
+    ListSort sort = ListSort::None;
+    int top = 0;                // only the first N after sorting (0 for no limit)
+    int page = 1;               // 1-based page number
+    int pageSize = 50;          // rows per section page (0 for no limit)
+};
+
+// Copy of a process taken under the index lock so it can be printed without it
+struct ProcessRow {
+    String name;
+    String timestamp;
+    int coreId;
+    int currentLine;
+    int totalLines;
+    ProcessState state;
+    uint64_t change;            // change sequence of the last state change
+};
+
+// One section of a listing
+struct ProcessPage {
+    std::vector<ProcessRow> rows;
+    size_t total = 0;           // processes in the section (only exact without a prefix filter)
+    bool hasMore = false;       // rows exist past this page
+};
+
+// Process indexes maintained by the scheduler: per-state and per-core intrusive lists,
+// plus a name index for prefix lookups. Listings walk only what they print.
+class ProcessIndex {
+private:
+    struct List {
+        Screen* head = nullptr;
+        Screen* tail = nullptr;
+        size_t size = 0;
+    };
+
+    typedef std::map<String, Screen*, std::less<String>, PoolAllocator<std::pair<const String, Screen*>>> NameIndex;
+
+    List stateLists[5];                     // indexed by ProcessState
+    std::vector<List> coreLists;            // processes currently running on each core
+    NodePool nameNodes;                     // nodes of byName
+    NameIndex byName;                       // ordered for prefix lookups
+    uint64_t changes = 0;                   // state changes so far; stamps Screen::stateChange
+    uint64_t removals = 0;                  // processes removed so far; invalidates scan cursors
+    mutable ProfiledMutex indexMutex{ LockSite::ProcessIndex };
+
+    static const size_t scanChunk = 256;    // rows copied per lock by scan
+
+    void linkState(Screen* screen);
+    void unlinkState(Screen* screen);
+    void linkCore(Screen* screen, int coreId);
+    void unlinkCore(Screen* screen);
+    bool matches(const Screen* screen, const ProcessQuery& query, ProcessState state) const;
+    void collect(const ProcessQuery& query, ProcessState state, ProcessPage& page) const;
+
+public:
+    explicit ProcessIndex(int numCores);
+    void add(Screen& screen);                           // register a newly created process
+    void addBatch(Screen* const* screens, size_t count);    // register many under one lock
+    void setState(Screen& screen, ProcessState state);  // move between state lists
+    void setStateBatch(Screen* const* screens, size_t count, ProcessState state);
+    void assignCore(Screen& screen, int coreId);        // move between core lists (-1 to detach)
+    void remove(Screen& screen);                        // forget a process that left the scheduler
+    size_t count(ProcessState state) const;
+    int busyCores() const;                              // cores with at least one process
+    ProcessPage page(const ProcessQuery& query, ProcessState state) const;
+    void top(ProcessState state, size_t count, const std::function<void(const Screen&)>& visit) const;  // most progressed first
+    void scan(ProcessState state, const std::function<void(const ProcessRow&)>& emit) const;  // every process in a state, streamed
+    uint64_t changeCount() const;
+    std::vector<ProcessRow> changedSince(uint64_t since, uint64_t& upTo) const;  // processes changed after since, in change order; upTo is the latest change
+};
+
+#endif // PROCESSINDEX_H
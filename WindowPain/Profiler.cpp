@@ -0,0 +1,187 @@
+#include "Profiler.h"
+
+#include <iomanip>
+#include <algorithm>
+
+using std::max;
+using std::min;
+
+std::atomic<bool> Profiler::active{ false };
+
+static const char* const lockNames[] = {
+    "ready queue", "core queue", "cfs tree", "process index", "process table", "name table", "admission",
+    "memory", "log cache", "io device",
+};
+
+static const char* const ioNames[] = { "log open", "log write", "log flush" };
+
+// Upper bounds of the printed histogram columns, in ns; the last column is open
+static const double columnNs[] = { 100, 1e3, 1e4, 1e5, 1e6, 1e7 };
+static const char* const columnNames[] = { "<100ns", "<1us", "<10us", "<100us", "<1ms", "<10ms", ">=10ms" };
+static const int columns = 7;
+
+Profiler::Timing::Timing() {
+    clear();
+}
+
+void Profiler::Timing::record(long long cycles) {
+    cycles = max(0LL, cycles);
+    count.fetch_add(1, std::memory_order_relaxed);
+    totalCycles.fetch_add(cycles, std::memory_order_relaxed);
+    long long seen = maxCycles.load(std::memory_order_relaxed);
+    while (cycles > seen && !maxCycles.compare_exchange_weak(seen, cycles, std::memory_order_relaxed)) {}
+
+    int bucket = 0;
+    for (long long rest = cycles >> 1; rest && bucket < buckets - 1; rest >>= 1) bucket++;
+    histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void Profiler::Timing::clear() {
+    count = 0;
+    totalCycles = 0;
+    maxCycles = 0;
+    for (auto& bucket : histogram) bucket = 0;
+}
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+void Profiler::reset(bool enable, int cores) {
+    active = false;
+    for (auto& lock : locks) {
+        lock.contended = 0;
+        lock.wait.clear();
+        lock.hold.clear();
+    }
+    for (auto& timing : io) timing.clear();
+    for (auto& core : this->cores) {
+        core.runCycles = 0;
+        core.ioCycles = 0;
+    }
+    numCores = min(cores, maxCores);
+    startCycles = cycles();
+    startTime = std::chrono::steady_clock::now();
+    active = enable;
+}
+
+void Profiler::recordWait(LockSite site, long long cycles, bool contended) {
+    LockProfile& lock = locks[static_cast<int>(site)];
+    if (contended) lock.contended.fetch_add(1, std::memory_order_relaxed);
+    lock.wait.record(cycles);
+}
+
+void Profiler::recordHold(LockSite site, long long cycles) {
+    locks[static_cast<int>(site)].hold.record(cycles);
+}
+
+void Profiler::recordIo(IoSite site, int coreId, long long cycles) {
+    io[static_cast<int>(site)].record(cycles);
+    if (coreId >= 0 && coreId < numCores) {
+        cores[coreId].ioCycles.fetch_add(cycles, std::memory_order_relaxed);
+    }
+}
+
+void Profiler::recordRun(int coreId, long long cycles) {
+    if (coreId >= 0 && coreId < numCores) {
+        cores[coreId].runCycles.fetch_add(cycles, std::memory_order_relaxed);
+    }
+}
+
+// Calibrated against the steady clock over the whole profiling run
+double Profiler::cyclesPerNs() const {
+#ifdef PROFILER_TSC
+    long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+    return ns > 0 ? static_cast<double>(cycles() - startCycles) / ns : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+// A bucket goes to the column its midpoint falls in, so the columns are approximate
+void Profiler::printHistogram(std::ostream& out, const char* label, const Timing& timing, double perNs) const {
+    long long counts[columns] = {};
+    for (int bucket = 0; bucket < buckets; ++bucket) {
+        long long hits = timing.histogram[bucket];
+        if (!hits) continue;
+        double ns = 1.5 * static_cast<double>(1LL << bucket) / perNs;
+        int column = 0;
+        while (column < columns - 1 && ns >= columnNs[column]) column++;
+        counts[column] += hits;
+    }
+
+    out << std::setw(15) << label;
+    for (long long count : counts) {
+        out << std::setw(10) << count;
+    }
+    out << "\n";
+}
+
+void Profiler::print(std::ostream& out) const {
+    double perNs = cyclesPerNs();
+    auto us = [perNs](long long cycles) { return cycles / perNs / 1e3; };
+    long long elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    out << "\n---------------------------------------\n";
+    out << "Profiled: " << std::fixed << std::setprecision(3) << elapsedMs / 1e3 << " s";
+#ifdef PROFILER_TSC
+    out << " (rdtsc, " << std::setprecision(2) << perNs << " cycles per ns)\n";
+#else
+    out << " (steady clock)\n";
+#endif
+    out << "\n";
+
+    out << std::left << std::setw(15) << "Lock" << std::setw(12) << "Acquired" << std::setw(12) << "Contended"
+        << std::setw(13) << "AvgWait(us)" << std::setw(13) << "MaxWait(us)" << std::setw(13) << "AvgHold(us)"
+        << std::setw(13) << "MaxHold(us)" << "Held%\n";
+    for (int i = 0; i < static_cast<int>(LockSite::Count); ++i) {
+        const LockProfile& lock = locks[i];
+        long long acquired = lock.wait.count;
+        if (!acquired) continue;
+        long long held = max(1LL, lock.hold.count.load());
+        out << std::setw(15) << lockNames[i] << std::setw(12) << acquired << std::setw(12) << lock.contended
+            << std::setprecision(3)
+            << std::setw(13) << us(lock.wait.totalCycles / acquired) << std::setw(13) << us(lock.wait.maxCycles)
+            << std::setw(13) << us(lock.hold.totalCycles / held) << std::setw(13) << us(lock.hold.maxCycles)
+            << std::setprecision(1) << (elapsedMs ? 100.0 * us(lock.hold.totalCycles) / 1e3 / elapsedMs : 0.0) << "\n";
+    }
+
+    for (int kind = 0; kind < 2; ++kind) {
+        out << "\n" << std::setw(15) << (kind == 0 ? "Wait" : "Hold");
+        for (const char* column : columnNames) out << std::setw(10) << column;
+        out << "\n";
+        for (int i = 0; i < static_cast<int>(LockSite::Count); ++i) {
+            const Timing& timing = kind == 0 ? locks[i].wait : locks[i].hold;
+            if (timing.count) printHistogram(out, lockNames[i], timing, perNs);
+        }
+    }
+
+    out << "\n" << std::setw(15) << "I/O" << std::setw(12) << "Calls" << std::setw(13) << "Avg(us)" << std::setw(13) << "Max(us)"
+        << "Total(s)\n";
+    for (int i = 0; i < static_cast<int>(IoSite::Count); ++i) {
+        const Timing& timing = io[i];
+        long long calls = timing.count;
+        out << std::setw(15) << ioNames[i] << std::setw(12) << calls << std::setprecision(3)
+            << std::setw(13) << (calls ? us(timing.totalCycles / calls) : 0.0) << std::setw(13) << us(timing.maxCycles)
+            << us(timing.totalCycles) / 1e6 << "\n";
+    }
+    out << "\n" << std::setw(15) << "I/O Time";
+    for (const char* column : columnNames) out << std::setw(10) << column;
+    out << "\n";
+    for (int i = 0; i < static_cast<int>(IoSite::Count); ++i) {
+        if (io[i].count) printHistogram(out, ioNames[i], io[i], perNs);
+    }
+
+    out << "\n" << std::setw(6) << "Core" << std::setw(11) << "Run(s)" << std::setw(11) << "LogIO(s)" << std::setw(11) << "Exec(s)"
+        << "LogIO%\n";
+    for (int i = 0; i < numCores; ++i) {
+        long long run = cores[i].runCycles, logIo = cores[i].ioCycles;
+        out << std::setw(6) << i << std::setprecision(3) << std::setw(11) << us(run) / 1e6 << std::setw(11) << us(logIo) / 1e6
+            << std::setw(11) << us(max(0LL, run - logIo)) / 1e6 << std::setprecision(1) << (run ? 100.0 * logIo / run : 0.0) << "\n";
+    }
+    out.unsetf(std::ios::fixed);
+    out << std::right;
+    out << "---------------------------------------\n\n";
+}
@@ -0,0 +1,150 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <ostream>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PROFILER_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_TSC 1
+#endif
+
+// Lock sites timed by the profiler. Every lock of one kind (each core's run queue, say)
+// is counted under the same site.
+enum class LockSite { ReadyQueue, CoreQueue, CfsTree, ProcessIndex, ProcessTable, NameTable, Admission, Memory, LogCache, Device, Count };
+
+// I/O calls timed by the profiler, all on the per-process log files
+enum class IoSite { LogOpen, LogWrite, LogFlush, Count };
+
+// Built-in profiling mode ("profile on" in config.txt): counts lock acquisitions with
+// wait and hold time histograms, and splits each core's run time into log I/O and
+// execution. Timestamps are raw cycle counts (rdtsc where available, the steady clock
+// elsewhere), converted to time only when printed. Process-wide like the allocation
+// counters, because locks outside the scheduler are timed as well. Off, every timed lock
+// costs one relaxed load.
+class Profiler {
+public:
+    static const int maxCores = 128;
+    static const int buckets = 48;      // power-of-two cycle buckets
+
+private:
+    struct Timing {
+        std::atomic<long long> count{ 0 };
+        std::atomic<long long> totalCycles{ 0 };
+        std::atomic<long long> maxCycles{ 0 };
+        std::atomic<long long> histogram[buckets];
+
+        Timing();
+        void record(long long cycles);
+        void clear();
+    };
+
+    struct alignas(64) LockProfile {
+        std::atomic<long long> contended{ 0 };  // acquisitions that found the lock taken
+        Timing wait;
+        Timing hold;
+    };
+
+    struct alignas(64) CoreProfile {
+        std::atomic<long long> runCycles{ 0 };  // inside dispatched processes
+        std::atomic<long long> ioCycles{ 0 };   // of which in log I/O
+    };
+
+    static std::atomic<bool> active;
+
+    LockProfile locks[static_cast<int>(LockSite::Count)];
+    Timing io[static_cast<int>(IoSite::Count)];
+    CoreProfile cores[maxCores];
+    int numCores = 0;
+    long long startCycles = 0;
+    std::chrono::steady_clock::time_point startTime;
+
+    double cyclesPerNs() const;
+    void printHistogram(std::ostream& out, const char* label, const Timing& timing, double perNs) const;
+
+public:
+    static Profiler& instance();
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+    static long long cycles() {
+#ifdef PROFILER_TSC
+        return static_cast<long long>(__rdtsc());
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    void reset(bool enable, int cores);     // clears the counts; only while no core runs
+    void recordWait(LockSite site, long long cycles, bool contended);
+    void recordHold(LockSite site, long long cycles);
+    void recordIo(IoSite site, int coreId, long long cycles);
+    void recordRun(int coreId, long long cycles);
+    void print(std::ostream& out) const;
+};
+
+// std::mutex that reports to the profiler while profiling is on. Usable wherever the
+// standard lock helpers are (lock_guard, unique_lock, std::lock, condition_variable_any).
+class ProfiledMutex {
+private:
+    std::mutex mutex;
+    LockSite site;
+    long long acquiredAt = 0;   // cycles at acquisition, written by the owner (0 when not timed)
+
+public:
+    explicit ProfiledMutex(LockSite site) : site(site) {}
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    void lock() {
+        if (!Profiler::enabled()) {
+            mutex.lock();
+            return;
+        }
+        long long start = Profiler::cycles();
+        bool contended = !mutex.try_lock();
+        if (contended) mutex.lock();
+        acquiredAt = Profiler::cycles();
+        Profiler::instance().recordWait(site, acquiredAt - start, contended);
+    }
+
+    bool try_lock() {
+        if (!mutex.try_lock()) return false;
+        if (Profiler::enabled()) {
+            acquiredAt = Profiler::cycles();
+            Profiler::instance().recordWait(site, 0, false);
+        }
+        return true;
+    }
+
+    void unlock() {
+        if (acquiredAt) {
+            long long held = Profiler::cycles() - acquiredAt;
+            acquiredAt = 0;
+            Profiler::instance().recordHold(site, held);
+        }
+        mutex.unlock();
+    }
+};
+
+// Times one log I/O call of a core while profiling is on
+class IoTimer {
+private:
+    IoSite site;
+    int coreId;
+    long long start;
+
+public:
+    IoTimer(IoSite site, int coreId) : site(site), coreId(coreId), start(Profiler::enabled() ? Profiler::cycles() : 0) {}
+    ~IoTimer() {
+        if (start) Profiler::instance().recordIo(site, coreId, Profiler::cycles() - start);
+    }
+    IoTimer(const IoTimer&) = delete;
+    IoTimer& operator=(const IoTimer&) = delete;
+};
+
+#endif // PROFILER_H
@@ -0,0 +1,115 @@
+#include "ReadyQueue.h"
+
+#include <algorithm>
+
+std::unique_ptr<ReadyQueue> ReadyQueue::create(const Config& config) {
+    if (config.ready_queue == "ring") {
+        return std::unique_ptr<ReadyQueue>(new RingReadyQueue(config.ready_queue_capacity));
+    }
+    return std::unique_ptr<ReadyQueue>(new LockedReadyQueue());
+}
+
+// Even share of a queue of the given depth, between 1 and maxCount
+static size_t batchSize(size_t depth, size_t maxCount, size_t sharers) {
+    size_t share = depth / (sharers ? sharers : 1);
+    return std::max<size_t>(1, std::min(share, maxCount));
+}
+
+bool LockedReadyQueue::push(Screen* screen) {
+    std::lock_guard<ProfiledMutex> lock(queueMutex);
+    locks++;
+    screenQueue.push(screen);
+    return true;
+}
+
+bool LockedReadyQueue::tryPop(Screen*& screen) {
+    std::lock_guard<ProfiledMutex> lock(queueMutex);
+    locks++;
+    if (screenQueue.empty()) return false;
+    screen = screenQueue.front();
+    screenQueue.pop();
+    return true;
+}
+
+size_t LockedReadyQueue::size() const {
+    std::lock_guard<ProfiledMutex> lock(queueMutex);
+    locks++;
+    return screenQueue.size();
+}
+
+size_t LockedReadyQueue::popBatch(Screen** out, size_t maxCount, size_t sharers) {
+    std::lock_guard<ProfiledMutex> lock(queueMutex);
+    locks++;
+    if (screenQueue.empty()) return 0;
+
+    size_t count = std::min(batchSize(screenQueue.size(), maxCount, sharers), screenQueue.size());
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = screenQueue.front();
+        screenQueue.pop();
+    }
+    return count;
+}
+
+size_t LockedReadyQueue::pushBatch(Screen* const* screens, size_t count) {
+    std::lock_guard<ProfiledMutex> lock(queueMutex);
+    locks++;
+    for (size_t i = 0; i < count; ++i) {
+        screenQueue.push(screens[i]);
+    }
+    return count;
+}
+
+RingReadyQueue::RingReadyQueue(size_t capacity) : ring(capacity), overflow(Blocks::allocator_type(&overflowBlocks)) {}
+
+bool RingReadyQueue::push(Screen* screen) {
+    return ring.tryPush(screen);
+}
+
+void RingReadyQueue::pushOverflow(Screen* screen) {
+    if (ring.tryPush(screen)) return;
+
+    std::lock_guard<ProfiledMutex> lock(overflowMutex);
+    locks++;
+    overflow.push_back(screen);
+    overflowSize++;
+}
+
+// The overflow is only locked while it holds something, so the ring stays lock-free
+size_t RingReadyQueue::popOverflow(Screen** out, size_t maxCount) {
+    if (overflowSize == 0) return 0;
+
+    std::lock_guard<ProfiledMutex> lock(overflowMutex);
+    locks++;
+    size_t taken = 0;
+    while (taken < maxCount && !overflow.empty()) {
+        out[taken++] = overflow.front();
+        overflow.pop_front();
+    }
+    overflowSize -= taken;
+    return taken;
+}
+
+bool RingReadyQueue::tryPop(Screen*& screen) {
+    return popOverflow(&screen, 1) == 1 || ring.tryPop(screen);
+}
+
+size_t RingReadyQueue::size() const {
+    return ring.size() + overflowSize;
+}
+
+size_t RingReadyQueue::popBatch(Screen** out, size_t maxCount, size_t sharers) {
+    size_t count = batchSize(size(), maxCount, sharers);
+    size_t taken = popOverflow(out, count);
+    while (taken < count && ring.tryPop(out[taken])) {
+        taken++;
+    }
+    return taken;
+}
+
+size_t RingReadyQueue::pushBatch(Screen* const* screens, size_t count) {
+    size_t pushed = 0;
+    while (pushed < count && ring.tryPush(screens[pushed])) {
+        pushed++;
+    }
+    return pushed;
+}
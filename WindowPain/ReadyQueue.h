@@ -0,0 +1,84 @@
+#ifndef READYQUEUE_H
+#define READYQUEUE_H
+
+#include "Config.h"
+#include "MpmcRing.h"
+#include "Pool.h"
+#include "Profiler.h"
+#include <queue>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <atomic>
+
+class Screen;
+
+// Queue of processes waiting for a core. Blocking and wakeups are left to the scheduler.
+class ReadyQueue {
+public:
+    virtual ~ReadyQueue() = default;
+    virtual bool push(Screen* screen) = 0;      // false when the queue is full
+    virtual void pushOverflow(Screen* screen) = 0;  // never fails, for threads that must not wait on a full queue
+    virtual bool tryPop(Screen*& screen) = 0;   // false when the queue is empty
+    virtual size_t size() const = 0;
+    virtual const char* name() const = 0;
+
+    // Takes up to maxCount processes, but no more than an even share of the queue
+    // split between sharers (at least one). Returns how many were taken.
+    virtual size_t popBatch(Screen** out, size_t maxCount, size_t sharers) = 0;
+    virtual size_t pushBatch(Screen* const* screens, size_t count) = 0;   // how many fit
+    virtual long long lockCount() const { return 0; }                    // lock acquisitions so far
+
+    static std::unique_ptr<ReadyQueue> create(const Config& config);
+};
+
+// std::queue guarded by a mutex; unbounded. Its blocks come from a pool, so a queue that
+// has reached its peak length stops allocating.
+class LockedReadyQueue : public ReadyQueue {
+private:
+    typedef std::deque<Screen*, PoolAllocator<Screen*>> Blocks;
+
+    NodePool blocks;
+    std::queue<Screen*, Blocks> screenQueue;
+    mutable ProfiledMutex queueMutex{ LockSite::ReadyQueue };
+    mutable std::atomic<long long> locks{ 0 };
+public:
+    LockedReadyQueue() : screenQueue(Blocks(Blocks::allocator_type(&blocks))) {}
+    bool push(Screen* screen) override;
+    void pushOverflow(Screen* screen) override { push(screen); }
+    bool tryPop(Screen*& screen) override;
+    size_t size() const override;
+    const char* name() const override { return "locked"; }
+    size_t popBatch(Screen** out, size_t maxCount, size_t sharers) override;
+    size_t pushBatch(Screen* const* screens, size_t count) override;
+    long long lockCount() const override { return locks; }
+};
+
+// Preallocated lock-free ring; bounded by ready-queue-capacity. Cores requeueing into a
+// full ring cannot wait for a slot, since they may be the ones that would free it, so
+// their processes go to a locked overflow list that pops drain first.
+class RingReadyQueue : public ReadyQueue {
+private:
+    typedef std::deque<Screen*, PoolAllocator<Screen*>> Blocks;
+
+    MpmcRing<Screen*> ring;
+    NodePool overflowBlocks;
+    Blocks overflow;
+    ProfiledMutex overflowMutex{ LockSite::ReadyQueue };
+    std::atomic<size_t> overflowSize{ 0 };
+    std::atomic<long long> locks{ 0 };
+
+    size_t popOverflow(Screen** out, size_t maxCount);
+public:
+    explicit RingReadyQueue(size_t capacity);
+    bool push(Screen* screen) override;
+    void pushOverflow(Screen* screen) override;
+    bool tryPop(Screen*& screen) override;
+    size_t size() const override;
+    const char* name() const override { return "ring"; }
+    size_t popBatch(Screen** out, size_t maxCount, size_t sharers) override;
+    size_t pushBatch(Screen* const* screens, size_t count) override;
+    long long lockCount() const override { return locks; }
+};
+
+#endif // READYQUEUE_H
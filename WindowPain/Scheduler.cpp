@@ -1,169 +1,1022 @@
 #include "Scheduler.h"
+#include "SchedulerPolicy.h"
 #include "Screen.h"
 #include "Utils.h"
 #include "Config.h"
+#include "AllocStats.h"
 
-#include <fstream>
+#include <cstdio>
 #include <chrono>
 #include <ctime>
 #include <algorithm>
+#include <iomanip>
+#include <cstring>
+#include <climits>
 
 using std::max;
 using std::min;
 
+static thread_local bool onCore = false;    // set on the core threads
+
 Scheduler::Scheduler(const Config& config)
-    : config(config), finished(false), numCores(config.num_cpu), nextCore(0),
-    schedulerType(config.scheduler == "rr" ? SchedulerType::RR : SchedulerType::FCFS),
-    quantumCycles(config.quantum_cycles) {
+    : numCores(config.num_cpu), quantumCycles(config.quantum_cycles), maxBatch(config.dispatch_batch), index(config.num_cpu), memory(config),
+    admission(config, [this]() { return index.count(ProcessState::Ready); }),
+    logCache(static_cast<size_t>(max(config.log_cache_size, config.num_cpu))),
+    tracer(config.num_cpu, static_cast<size_t>(config.trace_buffer_events)),
+    devices(config, [this](Screen& screen) { enqueue(screen); }),
+    origin(std::chrono::steady_clock::now()), config(config) {
 
-    // Set up threads based on the number of CPUs from the config
+    idleMask[0] = 0;
+    idleMask[1] = 0;
     for (int i = 0; i < config.num_cpu; ++i) {
-        cores.emplace_back(&Scheduler::worker, this, i);
+        slots.emplace_back(new CoreSlot());
+    }
+
+    // Shards of a cluster publish into the cluster region instead of the one status page
+    if (config.status_page_ticks > 0 && config.cluster_shards == 0 && status.open()) {
+        addTickHook(config.status_page_ticks, [this](long long tick) { publishStatus(tick); });
+    }
+
+    // Pending processes are admitted as the ready queue drains
+    if (admission.limited()) {
+        addTickHook(1, [this](long long) {
+            ArenaScope scratch;
+            ScratchVector<Screen*> admitted;
+            admission.poll(admitted);
+            for (Screen* screen : admitted) {
+                place(*screen);
+            }
+        });
+    }
+
+    if (devices.enabled()) {
+        addTickHook(1, [this](long long) { devices.sample(activeCoreCount() > 0); });
     }
 }
 
 Scheduler::~Scheduler() {
-    finished = true;
-    cv.notify_all();
+    stop();
+}
+
+// Policy schedulers call this from their destructor, so no core is still running
+// policy code while the run queue is destroyed. Devices stop last, as cores still
+// submit requests until they are joined.
+void Scheduler::stop() {
+    finish();
+    if (tickThread.joinable()) {
+        tickThread.join();
+    }
     for (auto& core : cores) {
-        core.join();
+        if (core.joinable()) core.join();
     }
+    devices.stop();
 }
 
-void Scheduler::worker(int coreId) {
-    while (true) {
-        if (finished) return;
+void Scheduler::addTickHook(int everyTicks, std::function<void(long long)> run) {
+    tickHooks.push_back({ max(1, everyTicks), std::move(run) });
+}
 
-        Screen* screen = nullptr;
+void Scheduler::start() {
+    tickThread = std::thread(&Scheduler::ticker, this);
+    devices.start();
 
-        {
-            std::unique_lock<std::mutex> lock(queueMutex);
-            cv.wait(lock, [this] {
-                return finished || !screenQueue.empty();
-                });
+    // Set up threads based on the number of CPUs from the config
+    for (int i = 0; i < config.num_cpu; ++i) {
+        cores.emplace_back(&Scheduler::worker, this, i);
+    }
+}
 
-            if (finished && screenQueue.empty()) {
-                return;
-            }
+long long Scheduler::currentTick() const {
+    return globalTick;
+}
 
-            if (!screenQueue.empty()) {
-                screen = screenQueue.front();
-                screenQueue.pop();
-                screen->coreId = coreId;
-                ++activeCores; // Increment active cores count
-            }
-            else {
+// One timer thread for the whole scheduler. Every tick it samples each core for CPU
+// accounting, asks cores whose process has used up its quantum to preempt it (cores
+// check the flag between instructions), and runs the periodic hooks that are due.
+void Scheduler::ticker() {
+    auto period = std::chrono::milliseconds(config.tick_ms);
+    auto next = std::chrono::steady_clock::now() + period;
+
+    while (!finished) {
+        std::this_thread::sleep_until(next);
+        next += period;
+        long long tick = ++globalTick;
+
+        for (auto& slot : slots) {
+            long long generation = slot->generation;
+            long long dispatched = slot->dispatchTick;
+            if (dispatched < 0) {
+                slot->idleTicks++;
                 continue;
             }
+            slot->busyTicks++;
+            long long slice = slot->sliceTicks;
+
+            // The request names the dispatch it was computed for, so one that reaches a
+            // core after its next dispatch has started is ignored there. A dispatch that
+            // began while we read the slot is left for the next tick.
+            if (slice >= 0 && tick - dispatched >= slice && slot->generation == generation) {
+                slot->preemptGeneration = generation;
+            }
         }
 
-        if (screen) {
-            if (schedulerType == SchedulerType::FCFS) {
-                executeProcessFCFS(screen, coreId);
+        for (const auto& hook : tickHooks) {
+            if (tick % hook.everyTicks == 0) {
+                hook.run(tick);
             }
-            else if (schedulerType == SchedulerType::RR) {
-                executeProcessRR(screen, coreId);
+        }
+        tickAllocations = threadAllocationCount();
+    }
+}
+
+void Scheduler::markIdle(int coreId) {
+    idleMask[coreId / 64].fetch_or(uint64_t(1) << (coreId % 64));
+}
+
+// True if this call took the core out of the idle mask
+bool Scheduler::clearIdle(int coreId) {
+    uint64_t bit = uint64_t(1) << (coreId % 64);
+    return (idleMask[coreId / 64].fetch_and(~bit) & bit) != 0;
+}
+
+// Takes one core out of the idle mask, the preferred one if it is idle
+int Scheduler::claimIdleCore(int preferred) {
+    if (preferred >= 0 && preferred < numCores && clearIdle(preferred)) {
+        return preferred;
+    }
+    for (int word = 0; word < 2; ++word) {
+        uint64_t mask = idleMask[word].load();
+        while (mask) {
+            int bit = 0;
+            while (!(mask & (uint64_t(1) << bit))) bit++;
+            if (clearIdle(word * 64 + bit)) {
+                return word * 64 + bit;
             }
-            --activeCores;
+            mask &= mask - 1;
         }
     }
+    return -1;
 }
 
-// FCFS: Complete execution of each screen process before moving to another process
-void Scheduler::executeProcessFCFS(Screen* screen, int coreId) {
-    screen->coreId = coreId;
-    std::ofstream logFile(screen->name + ".txt");
+// Wakes exactly one parked core, preferring the one the process last ran on.
+// Enqueuers only touch a core's mutex when that core is actually parked.
+void Scheduler::wakeIdleCore(int preferred) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int coreId = claimIdleCore(preferred);
+    if (coreId < 0) return;
 
-    for (int i = 0; i < screen->totalLines; ++i) {
-        if (screen->currentLine >= screen->totalLines) { // Extra safety check
-            screen->finished = true;
-            logFile.close();
-            return;
+    CoreSlot& slot = *slots[coreId];
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    slot.wakePending = true;
+    slot.wakeRequested = std::chrono::steady_clock::now();
+    slot.cv.notify_one();
+}
+
+// Print instructions left before the next I/O instruction; an I/O-bound process issues
+// one after every ioInterval prints
+static int linesBeforeIo(const Screen& screen) {
+    if (screen.ioInterval <= 0) return INT_MAX;
+    return screen.ioInterval - screen.currentLine % (screen.ioInterval + 1);
+}
+
+// Runs up to maxLines print instructions as one block: progress and the instruction count
+// are updated once and the log records are written together. Only used without an
+// execution delay, for processes that are not pipe ends.
+int Scheduler::runBlock(Screen* screen, int coreId, FILE* logFile, int maxLines) {
+    CoreSlot& slot = *slots[coreId];
+    int lines = min(maxLines, screen->totalLines - screen->currentLine);
+    {
+        IoTimer timer(IoSite::LogWrite, coreId);
+        slot.block.writePrints(logFile, slot.clock.now(), coreId, screen->nameEntry->message, lines);
+    }
+    screen->currentLine += lines;
+    return lines;
+}
+
+// Executes the next instruction of a process on this core: SEND for the sending end of
+// a pipe, RECV for the receiving end, an I/O request when an I/O-bound process is due
+// one, and a print for everything else. SEND and RECV do not advance when the mailbox is
+// full or empty; an I/O request advances, and the process then waits for its device.
+Scheduler::Step Scheduler::runInstruction(Screen* screen, int coreId, FILE* logFile) {
+    Mailbox* outbox = screen->outbox.get();
+    Mailbox* inbox = screen->inbox.get();
+    Message* sending = nullptr;
+    const Message* receiving = nullptr;
+
+    if (outbox) {
+        sending = outbox->ring.claim();
+        if (!sending) {
+            ipc.sendStalls++;
+            std::this_thread::yield();  // let the receiver drain before this core retries
+            return Step::Stalled;
+        }
+    }
+    else if (inbox) {
+        receiving = inbox->ring.front();
+        if (!receiving) {
+            if (!prepareBlock(*inbox)) return Step::Blocked;
+            receiving = inbox->ring.front();
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(50)); // Simulate work
-        // Get timestamp
-        time_t now = time(0);
-        tm ltm;
+    }
 
-#ifdef _WIN32
-        localtime_s(&ltm, &now);
-#else
-        localtime_r(&now, &ltm);
-#endif
-        char timestamp[25];
-        strftime(timestamp, sizeof(timestamp), "(%m/%d/%Y %I:%M:%S %p)", &ltm);
+    if (config.delays_per_exec > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(config.delays_per_exec)); // Simulate work
+    }
+    const char* timestamp = slots[coreId]->clock.now();
 
-        // Write log entry
-        logFile << timestamp << " Core:" << coreId << " \"Hello world from " << screen->name << "!\"\n";
-        logFile.flush();
+    if (sending) {
+        // Fill the slot in place, then publish it and wake the receiver if it is blocked
+        sending->sequence = screen->currentLine + 1;
+        sending->senderPid = screen->pid;
+        sending->sentNs = elapsedNs(origin);
+        snprintf(sending->payload, sizeof(sending->payload), "message %d from %s",
+            sending->sequence, screen->getName().c_str());
+        long long first = -1;
+        ipc.firstSendNs.compare_exchange_strong(first, sending->sentNs);
+        if (logFile) {
+            IoTimer timer(IoSite::LogWrite, coreId);
+            fprintf(logFile, "%s Core:%d SEND #%d to %s\n", timestamp, coreId,
+                sending->sequence, outbox->receiver->getName().c_str());
+        }
+        outbox->ring.publish();
+        ipc.sent++;
+        wakeReceiver(*outbox);
+    }
+    else if (receiving) {
+        long long received = elapsedNs(origin);
+        if (logFile) {
+            IoTimer timer(IoSite::LogWrite, coreId);
+            fprintf(logFile, "%s Core:%d RECV \"%s\"\n", timestamp, coreId, receiving->payload);
+        }
+        ipc.deliveryNs += received - receiving->sentNs;
+        ipc.lastReceiveNs = received;
+        inbox->ring.consume();
+        ipc.received++;
+    }
+    else if (linesBeforeIo(*screen) == 0) {
+        if (logFile) {
+            IoTimer timer(IoSite::LogWrite, coreId);
+            fprintf(logFile, "%s Core:%d IO request to device %d\n", timestamp, coreId, screen->ioDevice);
+        }
         screen->currentLine++;
+        return Step::IoWait;
     }
+    else if (logFile) {
+        // Write log entry
+        IoTimer timer(IoSite::LogWrite, coreId);
+        fprintf(logFile, "%s Core:%d %s", timestamp, coreId, screen->nameEntry->message.c_str());
+    }
+    screen->currentLine++;
+    return Step::Executed;
+}
+
+// Receiver found its mailbox empty: announce that it is about to block, then look again
+// so a SEND that raced with us is not missed. Returns true if a message is there after
+// all and the receiver keeps its core.
+bool Scheduler::prepareBlock(Mailbox& mailbox) {
+    mailbox.waiter.store(static_cast<int>(WaiterState::Blocking));
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (mailbox.ring.front() == nullptr) return false;
 
-    logFile.close();
-    screen->finished = true;
+    // Either nobody noticed, or a sender already marked us Woken; both leave us running
+    mailbox.waiter.store(static_cast<int>(WaiterState::Idle));
+    return true;
 }
 
-// RR: Process each screen with quantum-based execution
-void Scheduler::executeProcessRR(Screen* screen, int coreId) {
-    screen->coreId = coreId;
-    std::ofstream logFile(screen->name + ".txt", std::ios::app);
+// Called by the receiver's core once the receiver is off-core and indexed as blocked
+void Scheduler::parkReceiver(Screen& screen) {
+    Mailbox& mailbox = *screen.inbox;
+    mailbox.blockedAt = std::chrono::steady_clock::now();
+    ipc.blocks++;
+    ipc.parked++;   // counted before a sender can see it parked and wake it
 
-    int executedLines = 0;
-    while (executedLines < screen->totalLines) {
-        int linesToProcess = min(quantumCycles, screen->totalLines - executedLines);
+    int expected = static_cast<int>(WaiterState::Blocking);
+    if (!mailbox.waiter.compare_exchange_strong(expected, static_cast<int>(WaiterState::Parked))) {
+        // A SEND arrived while we were leaving the core; it left the requeue to us
+        ipc.parked--;
+        mailbox.waiter.store(static_cast<int>(WaiterState::Idle));
+        enqueue(screen);
+    }
+}
 
-        for (int i = 0; i < linesToProcess; ++i) {
-            if (screen->currentLine >= screen->totalLines) { // Extra safety check
-                screen->finished = true;
-                logFile.close();
+// Called by the sender after publishing a message
+void Scheduler::wakeReceiver(Mailbox& mailbox) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (;;) {
+        int state = mailbox.waiter.load();
+        if (state == static_cast<int>(WaiterState::Blocking)) {
+            // Still on its core: let that core requeue it
+            if (mailbox.waiter.compare_exchange_strong(state, static_cast<int>(WaiterState::Woken))) return;
+        }
+        else if (state == static_cast<int>(WaiterState::Parked)) {
+            if (mailbox.waiter.compare_exchange_strong(state, static_cast<int>(WaiterState::Idle))) {
+                ipc.parked--;
+                long long blocked = elapsedNs(mailbox.blockedAt);
+                ipc.blockedNs += blocked;
+                if (blocked > ipc.maxBlockedNs) ipc.maxBlockedNs = blocked;
+                enqueue(*mailbox.receiver);
                 return;
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(50)); // Simulate work
-            // Get timestamp
-            time_t now = time(0);
-            tm ltm;
+        }
+        else {
+            return;
+        }
+    }
+}
+
+// Moves a completed process out of the running indexes and hands its memory
+// to processes waiting in the backlog
+void Scheduler::finishProcess(Screen* screen) {
+    long long dispatched = slots[screen->coreId]->dispatchTick;
+    if (dispatched >= 0) {
+        screen->cpuTicks += globalTick - dispatched;
+    }
+
+    ArenaScope scratch;
+    ScratchVector<Screen*> admitted;
+    memory.release(*screen, admitted);
+    ScratchVector<Screen*> pending;
+    admission.leave(*screen, pending);
+
+    index.assignCore(*screen, -1);
+    index.setState(*screen, ProcessState::Finished);
+    screen->finished = true;    // last touch by the core; the process may be deleted after this
+
+    for (Screen* waiting : admitted) {
+        enqueue(*waiting);
+    }
+    for (Screen* waiting : pending) {
+        place(*waiting);
+    }
+}
+
+// Frees the admission slot of a process that will never run
+void Scheduler::releaseAdmission(Screen& screen) {
+    ArenaScope scratch;
+    ScratchVector<Screen*> pending;
+    admission.leave(screen, pending);
+    for (Screen* waiting : pending) {
+        place(*waiting);
+    }
+}
+
+// Accounts a process moving to another core. The penalty models refilling a cold cache:
+// the core stalls, and the stall counts against the process's slice.
+void Scheduler::migrate(Screen& screen, int fromCore, int toCore) {
+    screen.migrations++;
+    slots[fromCore]->migrationsOut++;
+    CoreSlot& slot = *slots[toCore];
+    slot.migrationsIn++;
+    processMigrations++;
+
+    if (config.migration_penalty > 0) {
+        auto stallStart = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<long long>(config.migration_penalty) * config.tick_ms));
+        slot.migrationStallNs += elapsedNs(stallStart);
+    }
+}
+
+// Counts a finished quantum and dumps the memory map every memory-snapshot-quanta quanta
+void Scheduler::endQuantum() {
+    long long quantum = ++quantumCount;
+    if (config.memory_snapshot_quanta > 0 && quantum % config.memory_snapshot_quanta == 0) {
+        memory.writeSnapshot(quantum);
+    }
+}
+
+void Scheduler::addProcess(Screen& screen) {
+    devices.assign(screen);
+    admission.enter(screen);
+    place(screen);
+}
+
+Admission Scheduler::submitProcess(Screen& screen, const std::atomic<bool>* canWait) {
+    devices.assign(screen);
+    Admission admitted = admission.submit(screen, canWait);
+    if (admitted == Admission::Admitted) {
+        place(screen);
+    }
+    return admitted;
+}
+
+// Processes after the admitted front of the batch are pending or dropped, like those of
+// a submitProcess that cannot wait
+Admission Scheduler::submitBatch(Screen* const* screens, size_t count, size_t& admittedCount) {
+    for (size_t i = 0; i < count; ++i) {
+        devices.assign(*screens[i]);
+    }
+    Admission rest = admission.submitBatch(screens, count, admittedCount);
+    placeBatch(screens, admittedCount);
+    return rest;
+}
 
-#ifdef _WIN32
-            localtime_s(&ltm, &now);
-#else
-            localtime_r(&now, &ltm);
-#endif
-            char timestamp[25];
-            strftime(timestamp, sizeof(timestamp), "(%m/%d/%Y %I:%M:%S %p)", &ltm);
+// Hands an admitted process to the ready queue. Processes that do not fit in memory wait
+// in the memory backlog instead.
+void Scheduler::place(Screen& screen) {
+    Placement placement = memory.place(screen);
+    if (placement == Placement::Placed) {
+        enqueue(screen);
+    }
+    else if (placement == Placement::Deferred) {
+        tracer.record(TraceType::Block, screen.nameEntry, -1);
+    }
+    else {
+        releaseAdmission(screen);   // larger than the whole memory, it will never run
+    }
+}
 
-            // Write log entry
-            logFile << timestamp << " Core:" << coreId << " \"Hello world from " << screen->name << "!\"\n";
-            logFile.flush();
-            screen->currentLine++;
+// Hands a batch of admitted processes to the run queue with one index update and one
+// push. With the memory model on, each process is placed on its own.
+void Scheduler::placeBatch(Screen* const* screens, size_t count) {
+    if (memory.enabled()) {
+        for (size_t i = 0; i < count; ++i) {
+            place(*screens[i]);
         }
+        return;
+    }
 
-        executedLines += linesToProcess;
+    index.setStateBatch(screens, count, ProcessState::Ready);
+    for (size_t i = 0; i < count; ++i) {
+        tracer.record(TraceType::Ready, screens[i]->nameEntry, -1);
+    }
 
-        if (executedLines < screen->totalLines) {
-            std::unique_lock<std::mutex> lock(queueMutex);
-            screenQueue.push(screen);  // Requeue the process for the next quantum
-            cv.notify_one();
-            break;  // Yield control to other processes
+    // A full ring pushes back on the producer, as in enqueue
+    size_t pushed = 0;
+    while (pushed < count) {
+        pushed += pushNewReady(screens + pushed, count - pushed);
+        if (pushed < count) {
+            if (finished) return;
+            std::this_thread::yield();
         }
     }
+    for (size_t i = 0; i < count && i < static_cast<size_t>(numCores); ++i) {
+        wakeIdleCore(-1);
+    }
+}
 
-    if (executedLines >= screen->totalLines) {
-        logFile.close();
-        screen->finished = true;
+// Only finished processes and processes that never reached the ready queue can be
+// removed; anything queued or running is still referenced by the cores.
+bool Scheduler::removeProcess(Screen& screen) {
+    bool removable = screen.finished;
+    if (!removable && screen.state == ProcessState::New) {
+        if (admission.withdraw(screen)) {
+            removable = true;
+        }
+        else if (memory.cancel(screen)) {
+            releaseAdmission(screen);
+            removable = true;
+        }
+    }
+    if (removable) {
+        index.remove(screen);
     }
+    return removable;
 }
 
-void Scheduler::addProcess(Screen& screen) {
-    {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        screen.coreId = nextCore;
-        screenQueue.push(&screen);
-        nextCore = (nextCore + 1) % numCores;
+// Takes up to maxCount waiting processes off this scheduler for another shard of the
+// cluster. Pipe ends stay with their peer. The rest give up their memory and admission
+// slot and leave every index, like finished processes, and belong to the caller.
+size_t Scheduler::emigrate(Screen** out, size_t maxCount) {
+    ArenaScope scratch;
+    ScratchVector<Screen*> taken(maxCount);
+    taken.resize(shedReady(taken.data(), maxCount));
+
+    size_t count = 0;
+    ScratchVector<Screen*> admitted;
+    ScratchVector<Screen*> pending;
+    for (Screen* screen : taken) {
+        if (screen->outbox || screen->inbox) {
+            enqueue(*screen);
+            continue;
+        }
+        memory.release(*screen, admitted);
+        admission.leave(*screen, pending);
+        index.remove(*screen);
+        logCache.close(screen->pid);
+        out[count++] = screen;
+    }
+
+    for (Screen* waiting : admitted) {
+        enqueue(*waiting);
+    }
+    for (Screen* waiting : pending) {
+        place(*waiting);
+    }
+    return count;
+}
+
+void Scheduler::connect(Screen& sender, Screen& receiver) {
+    auto mailbox = std::make_shared<Mailbox>(static_cast<size_t>(config.mailbox_slots));
+    mailbox->sender = &sender;
+    mailbox->receiver = &receiver;
+    sender.outbox = mailbox;
+    receiver.inbox = mailbox;
+}
+
+void Scheduler::enqueue(Screen& screen) {
+    screen.blockReason = BlockReason::None;
+    index.setState(screen, ProcessState::Ready);
+    tracer.record(TraceType::Ready, screen.nameEntry, -1);
+    int lastCoreId = screen.lastCoreId;     // the screen is not ours to read once queued
+
+    // A full ring pushes back on the console and the creators until a core frees a slot.
+    // A core never waits for one: every core could be waiting with none left to pop.
+    if (onCore) {
+        pushReadyOverflow(&screen);
+    }
+    else {
+        while (!pushReady(&screen)) {
+            if (finished) return;
+            std::this_thread::yield();
+        }
     }
-    cv.notify_one();
+    wakeIdleCore(lastCoreId);
 }
 
 void Scheduler::finish() {
     finished = true;
-    cv.notify_all(); // Notify all threads to finish execution
+
+    // Notify all threads to finish execution
+    for (auto& slot : slots) {
+        std::lock_guard<std::mutex> lock(slot->mutex);
+        slot->cv.notify_one();
+    }
+}
+
+int Scheduler::activeCoreCount() const {
+    int active = 0;
+    for (const auto& slot : slots) {
+        if (slot->busy) active++;
+    }
+    return active;
+}
+
+void Scheduler::printCoreStats(std::ostream& out) const {
+    long long instructions = instructionsExecuted;
+    long long locks = queueLocks();
+
+    out << "\n---------------------------------------\n";
+    out << "Policy: " << policyName() << "\n";
+    out << "Active Cores: " << activeCoreCount() << " / " << numCores << "\n";
+    out << "Scheduler Tick: " << globalTick << " (" << config.tick_ms << " ms)\n";
+    out << "Dispatch Batch: up to " << maxBatch << "\n";
+    out << "Instructions Executed: " << instructions << "\n";
+    out << "Ready Queue Locks: " << locks;
+    if (instructions > 0) {
+        out << " (" << static_cast<double>(locks) / instructions << " per instruction)";
+    }
+    out << "\n";
+    if (queueMigrations() > 0) {
+        out << "Run Queue Migrations: " << queueMigrations() << "\n";
+    }
+    long long dispatches = quantumCount;
+    out << "Process Migrations: " << processMigrations << " of " << dispatches << " dispatches";
+    if (dispatches > 0) {
+        out << " (" << std::fixed << std::setprecision(1) << 100.0 * processMigrations / dispatches << "%)";
+        out.unsetf(std::ios::fixed);
+    }
+    out << ", penalty " << config.migration_penalty << " ticks\n";
+    out << "\n";
+    out << std::setw(6) << std::left << "Core" << std::setw(7) << "State"
+        << std::setw(8) << "Busy%" << std::setw(11) << "Busy(s)" << std::setw(11) << "Parked(s)"
+        << std::setw(11) << "Poll(s)" << std::setw(12) << "Busy Ticks" << std::setw(10) << "Wakeups" << std::setw(14) << "AvgWake(us)"
+        << std::setw(13) << "MaxWake(us)" << std::setw(12) << "Mig In/Out" << "Stall(s)\n";
+
+    for (int i = 0; i < numCores; ++i) {
+        const CoreSlot& slot = *slots[i];
+        long long busy = slot.busyNs, parked = slot.parkedNs, poll = slot.pollNs, wakeups = slot.wakeups;
+        long long total = busy + parked + poll;
+
+        out << std::setw(6) << i << std::setw(7) << (slot.busy ? "busy" : "idle")
+            << std::fixed << std::setprecision(1)
+            << std::setw(8) << (total ? 100.0 * busy / total : 0.0)
+            << std::setprecision(3)
+            << std::setw(11) << busy / 1e9 << std::setw(11) << parked / 1e9 << std::setw(11) << poll / 1e9
+            << std::setw(12) << slot.busyTicks << std::setw(10) << wakeups
+            << std::setprecision(1)
+            << std::setw(14) << (wakeups ? slot.wakeLatencyNs / 1e3 / wakeups : 0.0)
+            << std::setw(13) << slot.maxWakeLatencyNs / 1e3
+            << std::setw(12) << (std::to_string(slot.migrationsIn) + "/" + std::to_string(slot.migrationsOut))
+            << std::setprecision(3) << slot.migrationStallNs / 1e9 << "\n";
+        out.unsetf(std::ios::fixed);
+    }
+    out << "---------------------------------------\n\n";
+}
+
+ProcessIndex& Scheduler::getIndex() {
+    return index;
+}
+
+LogCache& Scheduler::getLogCache() {
+    return logCache;
+}
+
+Tracer& Scheduler::getTracer() {
+    return tracer;
+}
+
+MemoryManager& Scheduler::getMemory() {
+    return memory;
+}
+
+IoDevices& Scheduler::getDevices() {
+    return devices;
+}
+
+void Scheduler::printIpcStats(std::ostream& out) const {
+    long long sent = ipc.sent;
+    long long received = ipc.received;
+    long long blocks = ipc.blocks;
+    long long first = ipc.firstSendNs;
+    long long span = first >= 0 ? ipc.lastReceiveNs - first : 0;
+
+    out << "\n---------------------------------------\n";
+    out << std::fixed << std::setprecision(3);
+    out << "Messages Sent: " << sent << "\n";
+    out << "Messages Received: " << received << "\n";
+    out << "Throughput: " << (span > 0 ? received * 1e9 / span : 0.0) << " messages/s\n";
+    out << "Avg Delivery Latency: " << (received > 0 ? ipc.deliveryNs / 1e6 / received : 0.0) << " ms\n";
+    out << "Send Stalls (mailbox full): " << ipc.sendStalls << "\n";
+    out << "Receiver Blocks: " << blocks << "\n";
+    out << "Blocked Time: " << ipc.blockedNs / 1e9 << " s total, "
+        << (blocks > 0 ? ipc.blockedNs / 1e6 / blocks : 0.0) << " ms avg, "
+        << ipc.maxBlockedNs / 1e6 << " ms max\n";
+    out << "Blocked Now: " << ipc.parked << "\n";     // on RECV; device waits are not IPC
+    out << std::defaultfloat;
+    out << "---------------------------------------\n\n";
+}
+
+template <size_t N>
+static void copyName(char (&out)[N], const String& name) {
+    size_t length = min(name.size(), N - 1);
+    memcpy(out, name.data(), length);
+    out[length] = '\0';
+}
+
+// Rewrites the status page from the tick thread. Everything is gathered before the
+// seqlock is taken, so readers see the page busy only for the copy.
+void Scheduler::publishStatus(long long tick) {
+    StatusSnapshot next;
+    collectStatus(next, tick);
+
+    StatusSnapshot& snapshot = status.beginWrite();
+    memcpy(&snapshot, &next, sizeof(next));
+    status.endWrite();
+}
+
+void Scheduler::collectStatus(StatusSnapshot& next, long long tick) const {
+    memset(&next, 0, sizeof(next));
+    next.publishedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    next.tick = tick;
+    next.tickMs = config.tick_ms;
+    copyName(next.policy, policyName());
+    next.numCores = min(numCores, statusMaxCores);
+    next.activeCores = activeCoreCount();
+
+    next.instructions = instructionsExecuted;
+    next.dispatches = quantumCount;
+    next.migrations = processMigrations;
+    next.queueLocks = queueLocks();
+
+    next.ready = static_cast<int64_t>(index.count(ProcessState::Ready));
+    next.running = static_cast<int64_t>(index.count(ProcessState::Running));
+    next.blocked = static_cast<int64_t>(index.count(ProcessState::Blocked));
+    next.finished = static_cast<int64_t>(index.count(ProcessState::Finished));
+    next.waitingForMemory = static_cast<int64_t>(memory.backlogSize());
+    next.live = admission.liveCount();
+    next.pendingAdmission = static_cast<int64_t>(admission.pendingCount());
+
+    for (int i = 0; i < next.numCores; ++i) {
+        const CoreSlot& slot = *slots[i];
+        StatusCore& core = next.cores[i];
+        const NameEntry* running = slot.running;
+        core.busy = slot.busy ? 1 : 0;
+        if (running) copyName(core.process, running->name);
+        core.busyTicks = slot.busyTicks;
+        core.idleTicks = slot.idleTicks;
+        core.wakeups = slot.wakeups;
+        core.migrationsIn = slot.migrationsIn;
+        core.migrationsOut = slot.migrationsOut;
+    }
+
+    for (ProcessState state : { ProcessState::Running, ProcessState::Ready }) {
+        if (next.topCount >= statusTopProcesses) break;
+        index.top(state, static_cast<size_t>(statusTopProcesses - next.topCount), [&next](const Screen& screen) {
+            StatusProcess& process = next.top[next.topCount++];
+            copyName(process.name, screen.getName());
+            process.state = static_cast<int32_t>(screen.state);
+            process.coreId = screen.coreId;
+            process.currentLine = screen.currentLine;
+            process.totalLines = screen.totalLines;
+        });
+    }
+}
+
+void Scheduler::printAdmissionStats(std::ostream& out) const {
+    admission.printStats(out);
+}
+
+// Counts are per thread, so the console's own allocations do not show up. Once the pools
+// and arenas have grown to the workload, the cores and the tick thread stop allocating
+// and "Since Last" stays at zero.
+void Scheduler::printAllocStats(std::ostream& out, const NodePool& processes) {
+    out << "\n---------------------------------------\n";
+    out << "Heap Allocations: " << heapAllocationCount() << " since start-up, all threads\n";
+    out << "Process Pool: " << processes.inUse() << " in use, " << processes.capacity() << " pooled\n";
+    out << "Log Buffers: " << logCache.buffersInUse() << " in use, " << logCache.buffersPooled() << " pooled ("
+        << LogCache::bufferSize() / 1024 << " KB each)\n";
+    out << "\n";
+    out << std::setw(8) << std::left << "Thread" << std::setw(14) << "Allocations" << "Since Last\n";
+
+    for (int i = 0; i < numCores; ++i) {
+        CoreSlot& slot = *slots[i];
+        long long allocations = slot.allocations;
+        out << std::setw(8) << ("Core " + std::to_string(i)) << std::setw(14) << allocations
+            << allocations - slot.reportedAllocations << "\n";
+        slot.reportedAllocations = allocations;
+    }
+    long long ticks = tickAllocations;
+    out << std::setw(8) << "Tick" << std::setw(14) << ticks << ticks - reportedTickAllocations << "\n";
+    reportedTickAllocations = ticks;
+    out << "---------------------------------------\n\n";
+}
+
+void Scheduler::wakeCreators() {
+    admission.wakeCreators();
+}
+
+// ---------------------------------------------------------------------------
+// Policy schedulers
+
+template <typename Policy>
+PolicyScheduler<Policy>::PolicyScheduler(const Config& config) : Scheduler(config), runQueue(config) {
+    if (Policy::balances) {
+        addTickHook(config.balance_interval, [this](long long) {
+            Policy::balance(runQueue, [this](int coreId) { wakeIdleCore(coreId); });
+        });
+    }
+}
+
+template <typename Policy>
+PolicyScheduler<Policy>::~PolicyScheduler() {
+    stop();
+}
+
+template <typename Policy>
+bool PolicyScheduler<Policy>::pushReady(Screen* screen) {
+    return runQueue.push(screen);
+}
+
+template <typename Policy>
+void PolicyScheduler<Policy>::pushReadyOverflow(Screen* screen) {
+    runQueue.pushOverflow(screen);
+}
+
+template <typename Policy>
+size_t PolicyScheduler<Policy>::pushNewReady(Screen* const* screens, size_t count) {
+    return runQueue.pushNew(screens, count);
+}
+
+template <typename Policy>
+size_t PolicyScheduler<Policy>::shedReady(Screen** out, size_t maxCount) {
+    return runQueue.shed(out, maxCount);
+}
+
+template <typename Policy>
+long long PolicyScheduler<Policy>::queueMigrations() const {
+    return runQueue.migrationCount();
+}
+
+template <typename Policy>
+long long PolicyScheduler<Policy>::queueLocks() const {
+    return runQueue.lockCount();
+}
+
+// Each core keeps a private run list filled by one ready queue operation and round-robins
+// it locally; leftovers go back to the shared queue together.
+template <typename Policy>
+void PolicyScheduler<Policy>::worker(int coreId) {
+    CoreSlot& slot = *slots[coreId];
+    onCore = true;
+    std::vector<Screen*> localRun(maxBatch);
+    std::vector<const NameEntry*> localNames(maxBatch);
+    std::vector<int> localCores(maxBatch);
+    size_t localCount = 0;
+
+    while (nextBatch(coreId, localRun.data(), localCount)) {
+        auto busyStart = std::chrono::steady_clock::now();
+        slot.busy = true;
+
+        // Keep cycling the local list while nothing else is waiting in the shared queue
+        do {
+            size_t kept = 0;
+            for (size_t i = 0; i < localCount; ++i) {
+                if (dispatch(localRun[i], coreId)) {
+                    localRun[kept++] = localRun[i];
+                }
+            }
+            localCount = kept;
+        } while (localCount > 0 && !finished && runQueue.empty(coreId));
+
+        // Return leftovers in one operation; whatever a full ring can't take stays local.
+        // A returned process may be taken by another core or sent to another shard as soon
+        // as it is in the queue, so what is traced afterwards is read before the push.
+        if (localCount > 0) {
+            for (size_t i = 0; i < localCount; ++i) {
+                localNames[i] = localRun[i]->nameEntry;
+                localCores[i] = localRun[i]->lastCoreId;
+            }
+            size_t returned = runQueue.pushBatch(coreId, localRun.data(), localCount);
+            for (size_t i = 0; i < returned; ++i) {
+                tracer.record(TraceType::Requeue, localNames[i], coreId);
+                wakeIdleCore(localCores[i]);
+            }
+            std::copy(localRun.begin() + returned, localRun.begin() + localCount, localRun.begin());
+            localCount -= returned;
+        }
+
+        slot.busy = false;
+        slot.busyNs += elapsedNs(busyStart);
+    }
+}
+
+// Runs one quantum of a process on this core. Returns true if it still has work left,
+// in which case it is left Ready for the caller to requeue.
+template <typename Policy>
+bool PolicyScheduler<Policy>::dispatch(Screen* screen, int coreId) {
+    CoreSlot& slot = *slots[coreId];
+    int previousCore = screen->lastCoreId;
+    screen->coreId = coreId;
+    screen->lastCoreId = coreId;
+    index.setState(*screen, ProcessState::Running);
+    index.assignCore(*screen, coreId);
+
+    const NameEntry* entry = screen->nameEntry;     // a finished process may be deleted by the time we trace
+    long long dispatched = globalTick;
+    slot.generation++;      // before the tick and slice, see ticker
+    slot.sliceTicks = Policy::timeSlice(runQueue, coreId, *screen, quantumCycles);
+    slot.dispatchTick = dispatched;
+    slot.running = entry;
+    tracer.record(TraceType::Dispatch, entry, coreId);
+    auto runStart = std::chrono::steady_clock::now();
+    if (previousCore >= 0 && previousCore != coreId) {
+        migrate(*screen, previousCore, coreId);
+    }
+
+    long long runStartCycles = Profiler::enabled() ? Profiler::cycles() : 0;
+    RunResult result = execute(screen, coreId);
+    if (runStartCycles) Profiler::instance().recordRun(coreId, Profiler::cycles() - runStartCycles);
+    bool more = result == RunResult::Preempted;
+
+    slot.dispatchTick = -1;
+    slot.running = nullptr;
+    tracer.record(more ? TraceType::Preempt : result == RunResult::Finished ? TraceType::Finish : TraceType::Block,
+        entry, coreId);
+
+    if (result != RunResult::Finished) {
+        screen->cpuTicks += globalTick - dispatched;
+        Policy::charge(runQueue, *screen, elapsedNs(runStart));
+        index.assignCore(*screen, -1);
+        if (!more) {
+            screen->blockReason = result == RunResult::IoWait ? BlockReason::Device : BlockReason::Receive;
+        }
+        index.setState(*screen, more ? ProcessState::Ready : ProcessState::Blocked);
+    }
+    if (result == RunResult::Blocked) {
+        parkReceiver(*screen);
+    }
+    else if (result == RunResult::IoWait) {
+        devices.submit(*screen);    // the completion may requeue it at once
+    }
+    endQuantum();
+    slot.allocations = threadAllocationCount();
+    return more;
+}
+
+// Fills the local run list from the ready queue, polling for a while and then parking in
+// the core's slot until an enqueue picks this core. Leftovers already in the list are run
+// first. Returns false once the scheduler is finished.
+template <typename Policy>
+bool PolicyScheduler<Policy>::nextBatch(int coreId, Screen** localRun, size_t& localCount) {
+    if (localCount > 0) return !finished;
+
+    CoreSlot& slot = *slots[coreId];
+    size_t batch = static_cast<size_t>(maxBatch);
+    auto pollStart = std::chrono::steady_clock::now();
+
+    while (!finished) {
+        for (int spin = 0; spin < idleSpins; ++spin) {
+            localCount = runQueue.popBatch(coreId, localRun, batch);
+            if (localCount > 0) {
+                slot.pollNs += elapsedNs(pollStart);
+                return true;
+            }
+            if (finished) break;
+            std::this_thread::yield();
+        }
+
+        slot.pollNs += elapsedNs(pollStart);
+        park(coreId);
+        pollStart = std::chrono::steady_clock::now();
+    }
+    return false;
+}
+
+template <typename Policy>
+void PolicyScheduler<Policy>::park(int coreId) {
+    CoreSlot& slot = *slots[coreId];
+    std::unique_lock<std::mutex> lock(slot.mutex);
+
+    // Advertise as idle, then re-check so an enqueue racing with us is not missed.
+    // If a waker already claimed this core it is blocked on our mutex and will
+    // deliver the wakeup once we wait.
+    markIdle(coreId);
+    if ((finished || !runQueue.empty(coreId)) && clearIdle(coreId)) {
+        return;
+    }
+
+    auto parkStart = std::chrono::steady_clock::now();
+    slot.cv.wait(lock, [&] {
+        return slot.wakePending || finished;
+        });
+
+    if (slot.wakePending) {
+        long long latency = elapsedNs(slot.wakeRequested);
+        slot.wakePending = false;
+        slot.wakeups++;
+        slot.wakeLatencyNs += latency;
+        if (latency > slot.maxWakeLatencyNs) slot.maxWakeLatencyNs = latency;
+    }
+    else {
+        clearIdle(coreId);
+    }
+    slot.parkedNs += elapsedNs(parkStart);
+}
+
+// Runs a process until it finishes, blocks on RECV, issues an I/O request, finds its
+// mailbox full or, under a preemptive policy, the tick thread asks for the core back
+template <typename Policy>
+typename Scheduler::RunResult PolicyScheduler<Policy>::execute(Screen* screen, int coreId) {
+    const std::atomic<long long>& preempt = slots[coreId]->preemptGeneration;
+    long long generation = slots[coreId]->generation.load(std::memory_order_relaxed);
+    screen->coreId = coreId;
+    FILE* logFile = nullptr;
+    if (config.process_logs) {
+        IoTimer timer(IoSite::LogOpen, coreId);
+        logFile = logCache.acquire(*screen->nameEntry, Policy::truncateLog(*screen));
+    }
+
+    // Without an execution delay, plain print instructions run as fused blocks, cut short
+    // at I/O instructions
+    bool fused = config.delays_per_exec == 0 && !screen->outbox && !screen->inbox;
+
+    Step step = Step::Executed;
+    int linesProcessed = 0;
+    long long flushedTick = globalTick;
+    while (screen->currentLine < screen->totalLines) {
+        if (Policy::preemptive && preempt.load(std::memory_order_relaxed) == generation) break;
+
+        // A process can keep its core for a long time (always under fcfs), so its log is
+        // also flushed once per tick and not only when it leaves the core
+        long long tick = globalTick.load(std::memory_order_relaxed);
+        if (tick != flushedTick && logFile) {
+            IoTimer timer(IoSite::LogFlush, coreId);
+            fflush(logFile);
+            flushedTick = tick;
+        }
+        int prints = fused ? min(linesBeforeIo(*screen), static_cast<int>(InstructionBlock::maxLines)) : 0;
+        if (prints > 0) {
+            linesProcessed += runBlock(screen, coreId, logFile, prints);
+            continue;
+        }
+        step = runInstruction(screen, coreId, logFile);
+        if (step == Step::Executed || step == Step::IoWait) linesProcessed++;
+        if (step != Step::Executed) break;
+    }
+    instructionsExecuted += linesProcessed;
+
+    // Unpin the log before another core can pick the process up; the handle stays cached
+    {
+        IoTimer timer(IoSite::LogFlush, coreId);
+        logCache.release(screen->pid);
+    }
+
+    if (step == Step::Blocked) return RunResult::Blocked;
+    if (step == Step::IoWait) return RunResult::IoWait;
+    if (screen->currentLine < screen->totalLines) {
+        return RunResult::Preempted;  // Yield control to other processes
+    }
+    finishProcess(screen);
+    return RunResult::Finished;
+}
+
+std::unique_ptr<Scheduler> Scheduler::create(const Config& config) {
+    if (config.scheduler == "rr") {
+        return std::unique_ptr<Scheduler>(new PolicyScheduler<RrPolicy>(config));
+    }
+    if (config.scheduler == "cfs") {
+        return std::unique_ptr<Scheduler>(new PolicyScheduler<CfsPolicy>(config));
+    }
+    return std::unique_ptr<Scheduler>(new PolicyScheduler<FcfsPolicy>(config));
 }
@@ -2,38 +2,161 @@
 #define SCHEDULER_H
 
 #include "Config.h"
-#include <queue>
+#include "ProcessIndex.h"
+#include "MemoryManager.h"
+#include "AdmissionControl.h"
+#include "CoreSlot.h"
+#include "LogCache.h"
+#include "Tracer.h"
+#include "StatusPublisher.h"
+#include "Mailbox.h"
+#include "IoDevices.h"
+#include "Pool.h"
+#include "Profiler.h"
+#include <chrono>
 #include <mutex>
 #include <condition_variable>
 #include <vector>
 #include <thread>
+#include <memory>
+#include <atomic>
+#include <ostream>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
 
 class Screen;
-enum class SchedulerType { FCFS, RR };
 
+// Machinery shared by every scheduling policy: cores and their parking slots, the tick
+// thread, process indexes, memory, logs, tracing, IPC and I/O devices. The dispatch path
+// lives in PolicyScheduler, which is compiled once per policy.
 class Scheduler {
-private:
-    std::queue<Screen*> screenQueue;
-    std::mutex queueMutex;
-    std::condition_variable cv;
-    bool finished = false;
+protected:
+    std::vector<std::unique_ptr<CoreSlot>> slots;   // parking slot and accounting per core
+    std::atomic<uint64_t> idleMask[2];              // parked cores, one bit per core (num-cpu <= 128)
+    std::atomic<bool> finished{ false };
     std::vector<std::thread> cores;
     int numCores;
-    int nextCore = 0;
 
-    SchedulerType schedulerType;
+    static const int idleSpins = 64;    // ready queue polls before an idle core parks
+
     int quantumCycles;
+    int maxBatch;           // most processes a core takes per ready queue operation
+    std::atomic<long long> instructionsExecuted{ 0 };
+
+    // Central tick source: advances globalTick every tick-ms, raises per-core preemption
+    // flags and runs periodic work
+    struct TickHook {
+        int everyTicks;
+        std::function<void(long long)> run;
+    };
+    std::thread tickThread;
+    std::atomic<long long> globalTick{ 0 };
+    std::vector<TickHook> tickHooks;
+    std::atomic<long long> tickAllocations{ 0 };    // heap allocations by the tick thread, updated every tick
+    long long reportedTickAllocations = 0;          // tick allocations at the last alloc-stat
+
+    ProcessIndex index;     // per-state and per-core process lists
+    MemoryManager memory;   // emulated memory and its backlog
+    AdmissionControl admission;     // max-ready / max-live limits and pending processes
+    LogCache logCache;      // open per-process log files
+    Tracer tracer;          // scheduling events for trace-export
+    StatusPublisher status; // shared-memory status page for external monitors
+    std::atomic<long long> quantumCount{ 0 };
+    std::atomic<long long> processMigrations{ 0 };  // dispatches on another core than the previous one
+    IpcStats ipc;           // SEND/RECV counters
+    IoDevices devices;      // emulated I/O devices and their request queues
+    std::chrono::steady_clock::time_point origin;   // scheduler start
 
-    void worker(int coreId);
-    void executeProcessFCFS(Screen* screen, int coreId);
-    void executeProcessRR(Screen* screen, int coreId);
+    enum class Step { Executed, Blocked, Stalled, IoWait };         // outcome of one instruction
+    enum class RunResult { Finished, Preempted, Blocked, IoWait };  // why a process left its core
+
+    // Policy hooks
+    virtual void worker(int coreId) = 0;
+    virtual bool pushReady(Screen* screen) = 0;             // false when the run queue is full
+    virtual void pushReadyOverflow(Screen* screen) = 0;     // never fails; for the cores
+    virtual size_t pushNewReady(Screen* const* screens, size_t count) = 0;  // how many fit
+    virtual size_t shedReady(Screen** out, size_t maxCount) = 0;    // take waiting processes for another shard
+    virtual long long queueLocks() const = 0;
+    virtual long long queueMigrations() const = 0;
+
+    void ticker();
+    void markIdle(int coreId);
+    bool clearIdle(int coreId);
+    int claimIdleCore(int preferred);
+    void wakeIdleCore(int preferred);
+    Step runInstruction(Screen* screen, int coreId, FILE* logFile);
+    int runBlock(Screen* screen, int coreId, FILE* logFile, int maxLines);
+    bool prepareBlock(Mailbox& mailbox);
+    void parkReceiver(Screen& screen);
+    void wakeReceiver(Mailbox& mailbox);
+    void migrate(Screen& screen, int fromCore, int toCore);
+    void finishProcess(Screen* screen);
+    void place(Screen& screen);
+    void placeBatch(Screen* const* screens, size_t count);
+    void releaseAdmission(Screen& screen);
+    void enqueue(Screen& screen);
+    void endQuantum();
+    void publishStatus(long long tick);
+
+    Scheduler(const Config& config);
 
 public:
     const Config& config; // Now Config is fully defined and can be used
-    Scheduler(const Config& config);
-    ~Scheduler();
-    void addProcess(Screen& screen);
+    virtual ~Scheduler();
+    static std::unique_ptr<Scheduler> create(const Config& config);    // policy from config.scheduler
+    virtual const char* policyName() const = 0;
+    void addProcess(Screen& screen);            // admit regardless of the admission limits
+    Admission submitProcess(Screen& screen, const std::atomic<bool>* canWait);  // admit within the limits, see AdmissionControl
+    Admission submitBatch(Screen* const* screens, size_t count, size_t& admittedCount);  // admit the front of a batch; outcome of the rest
+    bool removeProcess(Screen& screen);         // drop a process no core or queue can reach
+    size_t emigrate(Screen** out, size_t maxCount);  // hand ready processes to another shard, see ClusterNode
+    void connect(Screen& sender, Screen& receiver);  // pipe: every instruction of sender is a SEND, of receiver a RECV
     void finish();
+    void stop();                                // finish and join every thread; hooks may still use the scheduler
+    ProcessIndex& getIndex();
+    MemoryManager& getMemory();
+    LogCache& getLogCache();
+    Tracer& getTracer();
+    IoDevices& getDevices();
+    bool statusPageOpen() const { return status.isOpen(); }
+    const char* publishedPageName() const { return status.name(); }
+    void collectStatus(StatusSnapshot& out, long long tick) const;  // what the status page shows
+    void addTickHook(int everyTicks, std::function<void(long long)> run);  // call before start()
+    void start();                               // start the tick thread and the cores
+    long long currentTick() const;
+    int activeCoreCount() const;                // cores currently running a process
+    void printCoreStats(std::ostream& out) const;
+    void printIpcStats(std::ostream& out) const;
+    void printAdmissionStats(std::ostream& out) const;
+    void printAllocStats(std::ostream& out, const NodePool& processes);   // heap allocations per thread since the last call, pool use
+    void wakeCreators();                        // blocked submitProcess calls recheck canWait
+};
+
+// Scheduler specialized for one policy (see SchedulerPolicy.h). The policy supplies the
+// run queue, the quantum and charging rules and the log rule as compile-time members, so the worker,
+// dispatch and instruction loop carry no per-dispatch policy branches.
+template <typename Policy>
+class PolicyScheduler : public Scheduler {
+private:
+    typename Policy::RunQueue runQueue;
+
+    void worker(int coreId) override;
+    bool pushReady(Screen* screen) override;
+    void pushReadyOverflow(Screen* screen) override;
+    size_t pushNewReady(Screen* const* screens, size_t count) override;
+    size_t shedReady(Screen** out, size_t maxCount) override;
+    long long queueLocks() const override;
+    long long queueMigrations() const override;
+    bool nextBatch(int coreId, Screen** localRun, size_t& localCount);
+    void park(int coreId);
+    bool dispatch(Screen* screen, int coreId);
+    RunResult execute(Screen* screen, int coreId);
+
+public:
+    explicit PolicyScheduler(const Config& config);
+    ~PolicyScheduler() override;
+    const char* policyName() const override { return Policy::name(); }
 };
 
 #endif // SCHEDULER_H
@@ -0,0 +1,62 @@
+#ifndef SCHEDULERPOLICY_H
+#define SCHEDULERPOLICY_H
+
+#include "Config.h"
+#include "Screen.h"
+#include "SharedRunQueue.h"
+#include "CfsRunQueue.h"
+#include <functional>
+
+// Scheduling policies, plugged into PolicyScheduler at compile time. A policy names
+//  - RunQueue: where ready processes wait, with push/pushOverflow/pushNew/popBatch/pushBatch/
+//    shed/empty/lockCount/migrationCount
+//  - preemptive / timeSlice: whether the tick thread takes the core back, and after how
+//    many ticks (-1 for never)
+//  - charge: what a quantum costs the process, for policies that order by usage
+//  - balances / balance: periodic work on the run queue every balance-interval ticks
+//  - truncateLog: whether a dispatch starts the process log afresh
+// Processes that leave their core with work left are handed back with pushBatch.
+
+// First come, first served: a process keeps its core until it finishes
+struct FcfsPolicy {
+    typedef SharedRunQueue RunQueue;
+    static const bool preemptive = false;
+    static const bool balances = true;
+
+    static const char* name() { return "fcfs"; }
+    static long long timeSlice(const RunQueue&, int, const Screen&, int) { return -1; }
+    static void charge(RunQueue&, Screen&, long long) {}
+    static void balance(RunQueue& queue, const std::function<void(int)>& wake) { queue.balance(wake); }
+    static bool truncateLog(const Screen& screen) { return screen.currentLine == 0; }
+};
+
+// Round robin: the tick thread preempts a process after quantum-cycles ticks
+struct RrPolicy {
+    typedef SharedRunQueue RunQueue;
+    static const bool preemptive = true;
+    static const bool balances = true;
+
+    static const char* name() { return "rr"; }
+    static long long timeSlice(const RunQueue&, int, const Screen&, int quantumCycles) { return quantumCycles; }
+    static void charge(RunQueue&, Screen&, long long) {}
+    static void balance(RunQueue& queue, const std::function<void(int)>& wake) { queue.balance(wake); }
+    static bool truncateLog(const Screen&) { return false; }
+};
+
+// Completely fair: each core runs its waiting process with the lowest virtual runtime for
+// a weighted share of the quantum-cycles latency period
+struct CfsPolicy {
+    typedef CfsRunQueue RunQueue;
+    static const bool preemptive = true;
+    static const bool balances = true;
+
+    static const char* name() { return "cfs"; }
+    static long long timeSlice(const RunQueue& queue, int coreId, const Screen& screen, int) {
+        return queue.timeSlice(coreId, screen);
+    }
+    static void charge(RunQueue& queue, Screen& screen, long long ranNs) { queue.charge(screen, ranNs); }
+    static void balance(RunQueue& queue, const std::function<void(int)>& wake) { queue.balance(wake); }
+    static bool truncateLog(const Screen&) { return false; }
+};
+
+#endif // SCHEDULERPOLICY_H
@@ -1,7 +1,9 @@
 #include "Utils.h"
 #include "Screen.h"
 
-Screen::Screen() : name("Untitled"), currentLine(0), totalLines(-1), coreId(-1), finished(false) {}
-
-Screen::Screen(const String& name, int totalLines)
-    : name(name), currentLine(0), totalLines(totalLines), coreId(-1), finished(false) {}
+Screen::Screen(const NameEntry& entry, int totalLines)
+    : pid(entry.pid), globalPid(-1), nameEntry(&entry), currentLine(0), totalLines(totalLines), coreId(-1), lastCoreId(-1), migrations(0), finished(false), admitted(false), cpuTicks(0), nice(0), vruntime(0),
+    state(ProcessState::New), blockReason(BlockReason::None), stateChange(0), statePrev(nullptr), stateNext(nullptr), corePrev(nullptr), coreNext(nullptr), indexedCore(-1),
+    memoryBase(-1), memorySize(0), ioInterval(0), ioDevice(-1) {
+    timestamp[0] = '\0';
+}
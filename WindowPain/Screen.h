@@ -2,19 +2,56 @@
 #define SCREEN_H
 
 #include "Utils.h"
+#include "NameTable.h"
 #include <string>
+#include <memory>
+#include <cstdint>
+
+struct Mailbox;
+
+// Scheduling state of a process, maintained by the scheduler
+enum class ProcessState { New, Ready, Running, Finished, Blocked };
+
+// What a Blocked process waits for
+enum class BlockReason { None, Receive, Device };
 
 class Screen {
 public:
-    String name;        // process name saved by user
+    int pid;            // interned name ID
+    long long globalPid;    // cluster-wide process ID, kept across shards (-1 outside a cluster)
+    const NameEntry* nameEntry; // process name saved by user, with its log path and message
     int currentLine;    // current line of instruction
     int totalLines;     // total lines of instruction
-    String timestamp;   // timestamp of when screen was created
+    char timestamp[24]; // when the screen was created, "%m/%d/%Y %I:%M:%S %p"
     int coreId;         // The core assigned to this process
+    int lastCoreId;     // core the process last ran on (-1 if never dispatched)
+    int migrations;     // dispatches on a different core than the previous one
     bool finished;      // Added flag to indicate if process is finished
+    bool admitted;      // holds an admission slot (set under the admission lock)
+    long long cpuTicks; // scheduler ticks spent on a core
+    int nice;           // -20 (most CPU) to 19 (least), used by the cfs policy
+    long long vruntime; // weighted ns on a core, used by the cfs policy
+
+    ProcessState state; // current scheduling state
+    BlockReason blockReason;    // why it is Blocked (None otherwise)
+    uint64_t stateChange;   // index change sequence of the last state change
+    Screen* statePrev;  // intrusive links for the per-state index
+    Screen* stateNext;
+    Screen* corePrev;   // intrusive links for the per-core index
+    Screen* coreNext;
+    int indexedCore;    // core list this screen is linked into (-1 if none)
+
+    int memoryBase;     // base address in emulated memory (-1 if not resident)
+    int memorySize;     // bytes of emulated memory
+
+    int ioInterval;     // print instructions between I/O requests (0 for CPU-bound)
+    int ioDevice;       // device its I/O requests go to (-1 for CPU-bound)
+
+    std::shared_ptr<Mailbox> outbox;    // pipe this process SENDs into (sender end)
+    std::shared_ptr<Mailbox> inbox;     // pipe this process RECVs from (receiver end)
 
-    Screen();
-    Screen(const String& name, int totalLines);
+    Screen(const NameEntry& entry, int totalLines);
+    const String& getName() const { return nameEntry->name; }
 };
 
-#endif // SCREEN_H
\ No newline at end of file
+#endif // SCREEN_H
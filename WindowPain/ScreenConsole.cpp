@@ -3,11 +3,13 @@
 #include "AConsole.h"
 #include "Screen.h"
 #include "Utils.h"
+#include "Config.h"
 
 #include <iostream>
 #include <unordered_map>
 #include <string>
 #include <functional>
+#include <mutex>
 #include <cstdlib>
 
 ScreenConsole::ScreenConsole(ScreenManager& sm, ConsoleManager& cm)
@@ -28,13 +30,36 @@ void ScreenConsole::draw() {
 }
 
 void ScreenConsole::processSMI() {
-    const String& currentScreenString = screenManager.currentScreen;
-    const Screen& currentScreen = screenManager.screens[currentScreenString];
+    std::unique_lock<ProfiledMutex> lock;
+    const Screen* screen = screenManager.findScreen(screenManager.currentScreen, lock);
+    if (!screen) {
+        printInColor("No screen found with this name.\n\n", "red");
+        return;
+    }
+    const Screen& currentScreen = *screen;
 
-    std::cout << "\nScreen Name: " << currentScreen.name << "\n";
+    std::cout << "\nScreen Name: " << currentScreen.getName() << "\n";
     std::cout << "Timestamp: " << currentScreen.timestamp << "\n";
+    if (currentScreen.globalPid >= 0) {
+        std::cout << "Cluster PID: " << currentScreen.globalPid << "\n";
+    }
     std::cout << "Current Line: " << currentScreen.currentLine << " / " << currentScreen.totalLines << "\n";
+    std::cout << "CPU Ticks: " << currentScreen.cpuTicks << "\n";
+    std::cout << "Migrations: " << currentScreen.migrations;
+    if (currentScreen.lastCoreId >= 0) {
+        std::cout << " (last ran on core " << currentScreen.lastCoreId << ")";
+    }
+    std::cout << "\n";
+    if (config.scheduler == "cfs") {
+        std::cout << "Nice: " << currentScreen.nice << "  vruntime: " << currentScreen.vruntime / 1000000 << " ms\n";
+    }
 
+    if (currentScreen.state == ProcessState::Blocked && currentScreen.blockReason == BlockReason::Receive) {
+        printInColor("Blocked on RECV\n", "yellow");
+    }
+    else if (currentScreen.state == ProcessState::Blocked && currentScreen.blockReason == BlockReason::Device) {
+        printInColor("Waiting on device " + std::to_string(currentScreen.ioDevice) + "\n", "yellow");
+    }
     if (currentScreen.finished) {
         printInColor("Finished!\n", "green");
     }
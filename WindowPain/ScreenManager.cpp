@@ -4,6 +4,8 @@
 #include "Scheduler.h"
 #include "Utils.h"
 #include "Config.h"
+#include "MemoryAllocator.h"
+#include "ClusterNode.h"
 
 #include <iostream>
 #include <fstream>
@@ -13,20 +15,42 @@
 #include <unordered_set>
 #include <sstream>
 #include <string>
+#include <tuple>
 #include <algorithm>
 #include <random>
+#include <vector>
+#include <thread>
+#include <limits>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
 
 using std::max;
 using std::min;
 
-ScreenManager::ScreenManager(ConsoleManager& cm) : consoleManager(cm), currentScreen(""), scheduler(nullptr), schedulerRunning(false), testRunning(false) {}
+static const size_t batchPerWorker = 4096;   // fewest processes worth a thread of screen -s-batch
 
-void ScreenManager::screenCreate(const String& name, const String &type) {
-    if (screens.find(name) != screens.end()) {
-        printInColor("Screen already exists with this name.\n\n", "red");
-        return;
+ScreenManager::ScreenManager(ConsoleManager& cm)
+    : consoleManager(cm), screens(ScreenMap::allocator_type(&processPool)), currentScreen(""), testRunning(false) {}
+
+ScreenManager::~ScreenManager() {
+    shutdown();
+}
+
+// Stops the generator and the cores before the processes they run are destroyed; also
+// closes the status page and leaves the cluster, which outlive the program otherwise.
+// The tick thread is joined first: its cluster hook reaches the scheduler through us.
+void ScreenManager::shutdown() {
+    stopGenerator();
+    if (scheduler) {
+        scheduler->stop();
     }
+    scheduler.reset();
+    cluster.detach();
+}
 
+// Creation time as shown by screen -ls, "%m/%d/%Y %I:%M:%S %p"
+static void stampCreation(char (&timestamp)[24]) {
     time_t now = time(0);
     tm ltm;
 #ifdef _WIN32
@@ -34,34 +58,191 @@ void ScreenManager::screenCreate(const String& name, const String &type) {
 #else
     localtime_r(&now, &ltm);
 #endif
-    char timestamp[25];
     strftime(timestamp, sizeof(timestamp), "%m/%d/%Y %I:%M:%S %p", &ltm);
+}
 
-    // Create a new screen
-    Screen newScreen(name, 100);
-    newScreen.timestamp = timestamp;
+// Seeded once per thread rather than for every process
+static std::mt19937& creationGenerator() {
+    static thread_local std::mt19937 generator(std::random_device{}());
+    return generator;
+}
+
+Screen* ScreenManager::screenCreate(const String& name, const String &type, int nice, long long globalPid) {
+    const NameEntry& entry = names.intern(name);
+    Screen* created;
+    {
+        std::lock_guard<ProfiledMutex> lock(screensMutex);
+        auto inserted = screens.emplace(std::piecewise_construct, std::forward_as_tuple(entry.pid),
+            std::forward_as_tuple(entry, 100));
+        created = inserted.second ? &inserted.first->second : nullptr;
+    }
+    if (!created) {
+        printInColor("Screen already exists with this name.\n\n", "red");
+        return nullptr;
+    }
+
+    Screen& screen = *created;
+    stampCreation(screen.timestamp);
+    screen.nice = nice;
+    screen.globalPid = globalPid >= 0 || !cluster.isAttached() ? globalPid : cluster.allocatePid();
+    scheduler->getIndex().add(screen);
 
-    // Add to map and update current screen
-    screens[name] = newScreen;
     if (type == "screenCreate") {
-        std::random_device rd;
-        std::mt19937 gen(rd());
         std::uniform_int_distribution<> dist(config.min_ins, config.max_ins);
+        int instructionCount = dist(creationGenerator());
+        screen.totalLines = instructionCount;
 
-        int instructionCount = dist(gen);
-        screens[name].totalLines = instructionCount;
+        // Add the new process to the scheduler; the console never blocks on admission
+        Admission admission = scheduler->submitProcess(screen, nullptr);
+        if (admission == Admission::Dropped) {
+            scheduler->removeProcess(screen);
+            {
+                std::lock_guard<ProfiledMutex> lock(screensMutex);
+                screens.erase(entry.pid);
+            }
+            printInColor("Process \"" + name + "\" rejected: admission limit reached.\n\n", "red");
+            return nullptr;
+        }
 
-        // Add the new process to the scheduler
-        scheduler->addProcess(screens[name]);
-        
         //currentScreen = name;
-        printInColor("Process \"" + name + "\" created successfully.\n\n", "green");
+        if (admission == Admission::Deferred) {
+            printInColor("Process \"" + name + "\" created, waiting for admission.\n\n", "yellow");
+        }
+        else {
+            printInColor("Process \"" + name + "\" created successfully.\n\n", "green");
+        }
+    }
+    return &screen;
+}
+
+// Creates <prefix>0 .. <prefix><count-1> as one batch: "screen -s-batch <prefix> <count>
+// [min max]". Names, log strings and instruction counts are built in parallel, every
+// thread drawing from its own generator; the processes then enter the name table, the
+// process table, the index and the run queue with one bulk operation each.
+void ScreenManager::screenCreateBatch(const String& args) {
+    std::istringstream iss(args);
+    String prefix;
+    long long count = 0;
+    if (!(iss >> prefix >> count) || count <= 0 || count > std::numeric_limits<int>::max()) {
+        printInColor("Usage: screen -s-batch <prefix> <count> [min max]\n\n", "red");
+        return;
+    }
+    int minIns = config.min_ins;
+    int maxIns = config.max_ins;
+    int low = 0;
+    int high = 0;
+    if (iss >> low) {
+        if (!(iss >> high) || low < 1 || high < low) {
+            printInColor("Error: min and max must satisfy 1 <= min <= max.\n\n", "red");
+            return;
+        }
+        minIns = low;
+        maxIns = high;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    size_t total = static_cast<size_t>(count);
+    std::vector<NameEntry> prepared(total);
+    std::vector<int> lines(total);
+
+    std::random_device rd;
+    unsigned seed = rd();
+    size_t workers = max<size_t>(1, min<size_t>(std::thread::hardware_concurrency(), total / batchPerWorker));
+    auto build = [&](size_t worker) {
+        std::seed_seq stream{ seed, static_cast<unsigned>(worker) };
+        std::mt19937 gen(stream);
+        std::uniform_int_distribution<> dist(minIns, maxIns);
+        for (size_t i = total * worker / workers; i < total * (worker + 1) / workers; ++i) {
+            prepared[i] = NameTable::makeEntry(-1, prefix + std::to_string(i));
+            lines[i] = dist(gen);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t worker = 1; worker < workers; ++worker) {
+        threads.emplace_back(build, worker);
+    }
+    build(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<const NameEntry*> entries;
+    names.internBatch(prepared, entries);
+
+    char timestamp[24];
+    stampCreation(timestamp);
+    long long firstGlobalPid = cluster.isAttached() ? cluster.allocatePids(count) : -1;
+
+    // Names that already have a process are skipped, as screen -s rejects them
+    std::vector<Screen*> created;
+    created.reserve(total);
+    {
+        std::lock_guard<ProfiledMutex> lock(screensMutex);
+        screens.reserve(screens.size() + total);
+        for (size_t i = 0; i < total; ++i) {
+            auto inserted = screens.emplace(std::piecewise_construct, std::forward_as_tuple(entries[i]->pid),
+                std::forward_as_tuple(*entries[i], lines[i]));
+            if (!inserted.second) continue;
+
+            Screen& screen = inserted.first->second;
+            memcpy(screen.timestamp, timestamp, sizeof(timestamp));
+            screen.globalPid = firstGlobalPid >= 0 ? firstGlobalPid + static_cast<long long>(i) : -1;
+            created.push_back(&screen);
+        }
+    }
+
+    scheduler->getIndex().addBatch(created.data(), created.size());
+    size_t admitted = 0;
+    Admission rest = scheduler->submitBatch(created.data(), created.size(), admitted);
+    size_t refused = created.size() - admitted;
+    if (rest == Admission::Dropped) {
+        for (size_t i = admitted; i < created.size(); ++i) {
+            scheduler->removeProcess(*created[i]);
+        }
+        std::lock_guard<ProfiledMutex> lock(screensMutex);
+        for (size_t i = admitted; i < created.size(); ++i) {
+            screens.erase(created[i]->pid);
+        }
+    }
+
+    long long elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    printInColor("Created " + std::to_string(rest == Admission::Dropped ? admitted : created.size()) + " processes in "
+        + std::to_string(elapsedMs) + " ms (" + std::to_string(workers) + " threads).\n", "green");
+    if (created.size() < total) {
+        printInColor(std::to_string(total - created.size()) + " skipped: a screen with that name already exists.\n", "yellow");
     }
+    if (rest == Admission::Deferred) {
+        printInColor(std::to_string(refused) + " waiting for admission.\n", "yellow");
+    }
+    else if (rest == Admission::Dropped) {
+        printInColor(std::to_string(refused) + " rejected: admission limit reached.\n", "red");
+    }
+    std::cout << "\n";
+}
+
+Screen* ScreenManager::findScreen(const String& name) {
+    int pid = names.find(name);
+    if (pid < 0) return nullptr;
+
+    std::lock_guard<ProfiledMutex> lock(screensMutex);
+    auto it = screens.find(pid);
+    return it != screens.end() ? &it->second : nullptr;
+}
+
+// For readers that keep the screen past the lookup. The cluster balancer frees the screens
+// it sends away under the same lock, so the screen stays valid until the lock is released.
+const Screen* ScreenManager::findScreen(const String& name, std::unique_lock<ProfiledMutex>& lock) {
+    int pid = names.find(name);
+    if (pid < 0) return nullptr;
+
+    lock = std::unique_lock<ProfiledMutex>(screensMutex);
+    auto it = screens.find(pid);
+    return it != screens.end() ? &it->second : nullptr;
 }
 
 void ScreenManager::screenRestore(const String& name) {
-    auto it = screens.find(name);
-    if (it == screens.end()) {
+    if (!findScreen(name)) {
         printInColor("No screen found with this name.\n\n", "red");
         return;
     }
@@ -73,75 +254,195 @@ void ScreenManager::screenRestore(const String& name) {
     consoleManager.switchConsole(ConsoleType::Screen);
 }
 
-void ScreenManager::screenList(const String& type) {
-    std::ostringstream output;  // Create a stream to capture output
-
-    std::unordered_set<int> activeCoreIds;
-    std::unordered_map<int, int> coreProcessCount;
+// Parses "screen -s <name> [--nice N]"
+bool ScreenManager::parseCreateOptions(const String& args, String& name, int& nice) {
+    std::istringstream iss(args);
+    if (!(iss >> name)) {
+        printInColor("Error: Missing process name.\n\n", "red");
+        return false;
+    }
 
-    // Active cores counting for cpu utilization
-    for (const auto& screen : screens) {
-        if (!screen.second.finished && screen.second.coreId != -1) {
-            coreProcessCount[screen.second.coreId]++;
-            activeCoreIds.insert(screen.second.coreId);
+    String option;
+    while (iss >> option) {
+        String value;
+        if (!(iss >> value)) {
+            printInColor("Error: Missing value for " + option + ".\n\n", "red");
+            return false;
+        }
+        if (option != "--nice") {
+            printInColor("Error: Unknown option " + option + ".\n\n", "red");
+            return false;
+        }
+        try {
+            nice = clamp(std::stoi(value), -20, 19);
+        }
+        catch (const std::exception&) {
+            printInColor("Error: Invalid value \"" + value + "\" for " + option + ".\n\n", "red");
+            return false;
         }
     }
+    return true;
+}
 
-    int activeCores = activeCoreIds.size();
-    int coresAvailable = max(0, config.num_cpu - activeCores);
-    double cpuUtilization = (static_cast<double>(activeCores) / config.num_cpu) * 100;
+// Parses the options of "screen -ls" into a listing query
+bool ScreenManager::parseListOptions(const String& args, ProcessQuery& query) {
+    std::istringstream iss(args);
+    String option;
 
-    // Capture CPU info to both console and file steam use
-    output << "\n---------------------------------------\n";
-    output << "CPU Utilization: " << cpuUtilization << "%" << "\n";
-    output << "Cores Used: " << activeCores << "\n";
-    output << "Cores Available: " << coresAvailable << "\n";
+    while (iss >> option) {
+        String value;
+        if (!(iss >> value)) {
+            printInColor("Error: Missing value for " + option + ".\n\n", "red");
+            return false;
+        }
 
-    output << "\n---------------------------------------\n";
-    output << "Running processes:\n";
-
-    int cnt_running = 0;
-    if (!screens.empty()) {
-        for (const auto& screen : screens) {
-            if (!screen.second.finished && screen.second.currentLine > 0) {
-                cnt_running++;
-                output << std::setw(10) << std::left << screen.first << "   "
-                    << "(" << screens[screen.first].timestamp << ")    "
-                    << "Core: " << std::setw(3) << std::left << screen.second.coreId << "   "
-                    << screen.second.currentLine << " / " << screen.second.totalLines << "\n";
+        try {
+            if (option == "--state") {
+                if (value == "all") query.state = StateFilter::All;
+                else if (value == "ready") query.state = StateFilter::Ready;
+                else if (value == "running") query.state = StateFilter::Running;
+                else if (value == "finished") query.state = StateFilter::Finished;
+                else if (value == "blocked") query.state = StateFilter::Blocked;
+                else throw std::invalid_argument(value);
+            }
+            else if (option == "--prefix") {
+                query.prefix = value;
+            }
+            else if (option == "--core") {
+                query.core = std::stoi(value);
             }
+            else if (option == "--top") {
+                query.top = max(0, std::stoi(value));
+            }
+            else if (option == "--sort") {
+                if (value == "progress") query.sort = ListSort::Progress;
+                else if (value == "age") query.sort = ListSort::Age;
+                else throw std::invalid_argument(value);
+            }
+            else if (option == "--page") {
+                query.page = max(1, std::stoi(value));
+            }
+            else if (option == "--page-size") {
+                query.pageSize = max(0, std::stoi(value));
+            }
+            else {
+                printInColor("Error: Unknown option " + option + ".\n\n", "red");
+                return false;
+            }
+        }
+        catch (const std::exception&) {
+            printInColor("Error: Invalid value \"" + value + "\" for " + option + ".\n\n", "red");
+            return false;
         }
     }
-    if (cnt_running == 0) {
-        output << "No running processes.\n";
+    return true;
+}
+
+static void printRow(std::ostream& output, const ProcessRow& row) {
+    output << std::setw(10) << std::left << row.name << "   "
+        << "(" << row.timestamp << ")    ";
+    if (row.state == ProcessState::Finished) {
+        output << "Finished" << std::left << "   ";
     }
+    else if (row.state == ProcessState::Running) {
+        output << "Core: " << std::setw(3) << std::left << row.coreId << "   ";
+    }
+    else {
+        output << std::setw(9) << (row.state == ProcessState::Blocked ? "Blocked" : "Ready") << "   ";
+    }
+    output << row.currentLine << " / " << row.totalLines << "\n";
+}
 
-    output << "\nFinished processes:\n";
-    int cnt_finished = 0;
-    if (!screens.empty()) {
-        for (const auto& screen : screens) {
-            if (screen.second.finished) {
-                cnt_finished++;
-                output << std::setw(10) << std::left << screen.first << "   "
-                    << "(" << screens[screen.first].timestamp << ")    "
-                    << "Finished" << std::left << "   "
-                    << screen.second.currentLine << " / " << screen.second.totalLines << "\n";
-            }
+// Prints one state section of a listing
+static void printSection(std::ostream& output, const ProcessPage& page, const ProcessQuery& query, const String& empty) {
+    for (const auto& row : page.rows) {
+        printRow(output, row);
+    }
+    if (page.rows.empty()) {
+        output << empty << "\n";
+    }
+    if (page.hasMore) {
+        output << "... more on page " << max(query.page, 1) + 1;
+        if (page.total > 0) {
+            output << " (" << page.total << " total)";
         }
+        output << "\n";
     }
-    if (cnt_finished == 0) {
-        output << "No finished processes.\n";
+}
+
+// A section that wants every process of a state is streamed from the index row by row,
+// so even the full report holds only a chunk of rows in memory
+static void listSection(std::ostream& output, const ProcessIndex& index, const ProcessQuery& query, ProcessState state,
+    const String& empty) {
+    bool everything = query.pageSize == 0 && query.top == 0 && query.sort == ListSort::None
+        && query.prefix.empty() && query.core < 0;
+    if (!everything) {
+        printSection(output, index.page(query, state), query, empty);
+        return;
     }
 
-    output << "---------------------------------------\n\n";
+    bool any = false;
+    index.scan(state, [&](const ProcessRow& row) {
+        printRow(output, row);
+        any = true;
+    });
+    if (!any) {
+        output << empty << "\n";
+    }
+}
+
+// One row per live shard of the cluster
+static void printShards(std::ostream& output, const std::vector<ShardStatus>& shards, int ownShard, int shardCount) {
+    output << "\nCluster: " << shards.size() << " of " << shardCount << " shards live, this is shard " << ownShard << "\n";
+    output << std::setw(7) << std::left << "Shard" << std::setw(9) << "PID" << std::setw(8) << "Cores"
+        << std::setw(7) << "Used" << std::setw(8) << "Ready" << std::setw(9) << "Blocked"
+        << std::setw(10) << "Finished" << std::setw(7) << "Sent" << "Received\n";
+    for (const ShardStatus& shard : shards) {
+        const StatusSnapshot& s = shard.snapshot;
+        output << std::setw(7) << (std::to_string(shard.shard) + (shard.shard == ownShard ? "*" : ""))
+            << std::setw(9) << shard.ownerPid << std::setw(8) << s.numCores << std::setw(7) << s.activeCores
+            << std::setw(8) << s.ready << std::setw(9) << s.blocked << std::setw(10) << s.finished
+            << std::setw(7) << shard.emigrated << shard.immigrated << "\n";
+    }
+}
 
+// Running processes other shards last published, in the layout of printSection
+static void printRemoteRunning(std::ostream& output, const std::vector<ShardStatus>& shards, int ownShard,
+    const ProcessQuery& query) {
+    bool any = false;
+    for (const ShardStatus& shard : shards) {
+        if (shard.shard == ownShard) continue;
+        for (int i = 0; i < shard.snapshot.topCount && i < statusTopProcesses; ++i) {
+            const StatusProcess& process = shard.snapshot.top[i];
+            String name = process.name;
+            if (process.state != static_cast<int32_t>(ProcessState::Running)
+                || name.compare(0, query.prefix.size(), query.prefix) != 0
+                || (query.core >= 0 && process.coreId != query.core)) {
+                continue;
+            }
+            output << std::setw(10) << std::left << name << "   "
+                << "(shard " << shard.shard << ")    "
+                << "Core: " << std::setw(3) << std::left << process.coreId << "   "
+                << process.currentLine << " / " << process.totalLines << "\n";
+            any = true;
+        }
+    }
+    if (!any) {
+        output << "No running processes.\n";
+    }
+}
+
+// Writes the listing straight to the console or to the report file as it is produced
+void ScreenManager::screenList(const String& type, const ProcessQuery& query) {
     if (type == "screenList") {
-        std::cout << output.str();
+        writeListing(std::cout, query);
     } else if (type == "reportUtil") {
         std::ofstream logFile("csopesy_log.txt");
         if (logFile.is_open()) {
-            logFile << output.str();
+            uint64_t changes = scheduler->getIndex().changeCount();
+            writeListing(logFile, query);
             logFile.close();
+            reportedChange = changes;
             printInColor("Report generated at csopesy_log.txt\n\n", "green");
         }
         else {
@@ -150,6 +451,279 @@ void ScreenManager::screenList(const String& type) {
     }
 }
 
+void ScreenManager::writeListing(std::ostream& output, const ProcessQuery& query) {
+    ProcessIndex& index = scheduler->getIndex();
+
+    // Other shards as of their last publish; this one is taken fresh
+    std::vector<ShardStatus> shards;
+    if (cluster.isAttached()) {
+        cluster.readShards(shards);
+        for (ShardStatus& shard : shards) {
+            if (shard.shard == cluster.shardId()) {
+                scheduler->collectStatus(shard.snapshot, scheduler->currentTick());
+            }
+        }
+    }
+
+    // Active cores counting for cpu utilization, over every shard of a cluster
+    int totalCores = config.num_cpu;
+    int activeCores = index.busyCores();
+    if (!shards.empty()) {
+        totalCores = 0;
+        activeCores = 0;
+        for (const ShardStatus& shard : shards) {
+            totalCores += shard.snapshot.numCores;
+            activeCores += shard.snapshot.activeCores;
+        }
+    }
+    int coresAvailable = max(0, totalCores - activeCores);
+    double cpuUtilization = totalCores > 0 ? (static_cast<double>(activeCores) / totalCores) * 100 : 0.0;
+
+    // Capture CPU info to both console and file steam use
+    output << "\n---------------------------------------\n";
+    output << "CPU Utilization: " << cpuUtilization << "%" << "\n";
+    output << "Cores Used: " << activeCores << "\n";
+    output << "Cores Available: " << coresAvailable << "\n";
+    if (!shards.empty()) {
+        printShards(output, shards, cluster.shardId(), cluster.shardCount());
+    }
+    if (scheduler->getDevices().enabled()) {
+        output << "\n";
+        scheduler->getDevices().printUtilization(output);
+    }
+
+    output << "\n---------------------------------------\n";
+
+    if (query.state == StateFilter::All || query.state == StateFilter::Running) {
+        output << "Running processes:\n";
+        listSection(output, index, query, ProcessState::Running, "No running processes.");
+        if (shards.size() > 1) {
+            output << "Running on other shards:\n";
+            printRemoteRunning(output, shards, cluster.shardId(), query);
+        }
+    }
+
+    if (query.state == StateFilter::Ready) {
+        output << "Ready processes:\n";
+        listSection(output, index, query, ProcessState::Ready, "No ready processes.");
+    }
+    else if (query.state == StateFilter::All) {
+        output << "Ready processes: " << index.count(ProcessState::Ready) << "\n";
+    }
+
+    if (query.state == StateFilter::Blocked) {
+        output << "Blocked processes:\n";
+        listSection(output, index, query, ProcessState::Blocked, "No blocked processes.");
+    }
+    else if (query.state == StateFilter::All && index.count(ProcessState::Blocked) > 0) {
+        output << "Blocked processes: " << index.count(ProcessState::Blocked) << "\n";
+    }
+
+    if (query.state == StateFilter::All || query.state == StateFilter::Finished) {
+        output << "\nFinished processes:\n";
+        listSection(output, index, query, ProcessState::Finished, "No finished processes.");
+    }
+
+    output << "---------------------------------------\n\n";
+}
+
+static const char* stateName(ProcessState state) {
+    switch (state) {
+    case ProcessState::New: return "New";
+    case ProcessState::Ready: return "Ready";
+    case ProcessState::Running: return "Running";
+    case ProcessState::Finished: return "Finished";
+    default: return "Blocked";
+    }
+}
+
+// Appends to csopesy_log.txt only the processes whose state changed since the previous
+// report, so a periodic report costs time in proportion to the activity in between.
+// Each block has the same column header and is numbered; rows carry the change
+// sequence, which orders them across blocks.
+void ScreenManager::reportChanges() {
+    uint64_t upTo = 0;
+    std::vector<ProcessRow> rows = scheduler->getIndex().changedSince(reportedChange, upTo);
+
+    std::ofstream logFile("csopesy_log.txt", std::ios::app);
+    if (!logFile.is_open()) {
+        printInColor("Error: Could not open csopesy_log.txt for writing.\n\n", "red");
+        return;
+    }
+
+    time_t now = time(0);
+    tm ltm;
+#ifdef _WIN32
+    localtime_s(&ltm, &now);
+#else
+    localtime_r(&now, &ltm);
+#endif
+    char timestamp[25];
+    strftime(timestamp, sizeof(timestamp), "%m/%d/%Y %I:%M:%S %p", &ltm);
+
+    logFile << "--- Report " << ++reportCount << " (" << timestamp << "): " << rows.size() << " changed";
+    if (upTo > reportedChange) {
+        logFile << ", sequence " << reportedChange + 1 << " to " << upTo;
+    }
+    logFile << " ---\n";
+    logFile << std::left << std::setw(10) << "Seq" << std::setw(14) << "Process" << std::setw(10) << "State"
+        << std::setw(6) << "Core" << "Progress\n";
+    for (const ProcessRow& row : rows) {
+        logFile << std::setw(10) << row.change << std::setw(14) << row.name << std::setw(10) << stateName(row.state)
+            << std::setw(6) << (row.state == ProcessState::Running ? std::to_string(row.coreId) : "-")
+            << row.currentLine << " / " << row.totalLines << "\n";
+    }
+    logFile.close();
+    reportedChange = upTo;
+
+    printInColor("Appended " + std::to_string(rows.size()) + " changed processes to csopesy_log.txt\n\n", "green");
+}
+
+// Runs on the tick thread every cluster-balance-ticks. Arrivals are taken in first, then
+// this shard publishes its load and sends the least loaded other shard enough waiting
+// processes to even out the ready processes per core between the two.
+void ScreenManager::balanceCluster(long long tick) {
+    std::vector<ClusterProcess> arrivals;
+    cluster.receive(arrivals);
+    for (const ClusterProcess& process : arrivals) {
+        immigrate(process);
+    }
+
+    StatusSnapshot snapshot;
+    scheduler->collectStatus(snapshot, tick);
+    cluster.publish(snapshot);
+
+    long long targetReady = 0;
+    long long targetCores = 0;
+    int target = cluster.leastLoaded(targetReady, targetCores);
+    if (target < 0) return;
+
+    long long cores = snapshot.numCores;
+    long long surplus = (snapshot.ready * targetCores - targetReady * cores) / (cores + targetCores);
+    size_t count = static_cast<size_t>(min<long long>(surplus, static_cast<long long>(cluster.freeSlots(target))));
+    if (surplus <= 0 || count == 0) return;
+
+    std::vector<Screen*> leaving(count);
+    leaving.resize(scheduler->emigrate(leaving.data(), count));
+    for (Screen* screen : leaving) {
+        ClusterProcess process;
+        memset(&process, 0, sizeof(process));
+        snprintf(process.name, sizeof(process.name), "%s", screen->getName().c_str());
+        snprintf(process.timestamp, sizeof(process.timestamp), "%s", screen->timestamp);
+        process.globalPid = screen->globalPid;
+        process.cpuTicks = screen->cpuTicks;
+        process.currentLine = screen->currentLine;
+        process.totalLines = screen->totalLines;
+        process.nice = screen->nice;
+        process.fromShard = cluster.shardId();
+        cluster.send(target, process);  // only this thread fills the ring, so the room checked above is still there
+
+        // Nothing in the scheduler refers to it any more; the console reads screens under this lock
+        std::lock_guard<ProfiledMutex> lock(screensMutex);
+        screens.erase(screen->pid);
+    }
+}
+
+// Recreates a process another shard sent. A name already taken here gets the sending
+// shard appended, so its log continues in a file of its own.
+void ScreenManager::immigrate(const ClusterProcess& process) {
+    String name = process.name;
+    if (findScreen(name)) {
+        name += "@" + std::to_string(process.fromShard);
+    }
+    Screen* screen = screenCreate(name, "cluster", process.nice, process.globalPid);
+    if (!screen) return;
+
+    snprintf(screen->timestamp, sizeof(screen->timestamp), "%s", process.timestamp);
+    screen->totalLines = process.totalLines;
+    screen->currentLine = process.currentLine;
+    screen->cpuTicks = process.cpuTicks;
+    scheduler->addProcess(*screen);
+}
+
+void ScreenManager::coreStat() {
+    scheduler->printCoreStats(std::cout);
+}
+
+void ScreenManager::memoryStat() {
+    scheduler->getMemory().printStats(std::cout);
+}
+
+void ScreenManager::ipcStat() {
+    scheduler->printIpcStats(std::cout);
+}
+
+void ScreenManager::admissionStat() {
+    scheduler->printAdmissionStats(std::cout);
+}
+
+void ScreenManager::profileDump() {
+    if (!Profiler::enabled()) {
+        printInColor("Profiling is off. Set profile on in config.txt and initialize again.\n\n", "red");
+        return;
+    }
+    Profiler::instance().print(std::cout);
+}
+
+void ScreenManager::allocStat() {
+    std::lock_guard<ProfiledMutex> lock(screensMutex);
+    scheduler->printAllocStats(std::cout, processPool);
+}
+
+// Creates sender/receiver pairs connected by pipes: "pipe<n>-tx" SENDs every
+// instruction to "pipe<n>-rx", which RECVs them
+void ScreenManager::ipcTest(const String& args) {
+    std::istringstream iss(args);
+    int pairs = 0;
+    int messages = 0;
+    if (!(iss >> pairs) || pairs <= 0) {
+        printInColor("Usage: ipc-test <pairs> [messages]\n\n", "red");
+        return;
+    }
+    iss >> messages;
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<> dist(config.min_ins, config.max_ins);
+
+    for (int i = 0; i < pairs; ++i) {
+        int count = messages > 0 ? messages : dist(gen);
+        String base = "pipe" + std::to_string(pipeCount++);
+        Screen* receiver = screenCreate(base + "-rx", "ipcTest");
+        Screen* sender = receiver ? screenCreate(base + "-tx", "ipcTest") : nullptr;
+        if (!sender) {
+            return;
+        }
+        receiver->totalLines = count;
+        sender->totalLines = count;
+        scheduler->connect(*sender, *receiver);
+        scheduler->addProcess(*receiver);
+        scheduler->addProcess(*sender);
+    }
+    printInColor("Created " + std::to_string(pairs) + " pipe pair(s).\n\n", "green");
+}
+
+void ScreenManager::traceExport(const String& filename) {
+    if (filename.empty()) {
+        printInColor("Usage: trace-export <file>\n\n", "red");
+        return;
+    }
+    Tracer& tracer = scheduler->getTracer();
+    if (!tracer.isEnabled()) {
+        printInColor("Tracing is disabled. Set trace-buffer-events in config.txt and initialize again.\n\n", "red");
+        return;
+    }
+    if (!tracer.exportJson(filename)) {
+        printInColor("Error: Could not open " + filename + " for writing.\n\n", "red");
+        return;
+    }
+    printInColor("Exported " + std::to_string(tracer.eventCount()) + " events to " + filename, "green");
+    if (tracer.droppedCount() > 0) {
+        printInColor(" (" + std::to_string(tracer.droppedCount()) + " dropped, buffers full)", "yellow");
+    }
+    std::cout << "\n\n";
+}
+
 void ScreenManager::schedulerTest() {
     // Ensure only one instance of the scheduler runs at a time
     if (testRunning) {
@@ -158,23 +732,32 @@ void ScreenManager::schedulerTest() {
     }
 
     printInColor("Scheduler-test has started.\n\n", "yellow");
+    stopGenerator();    // reap the generator of a previous run
     testRunning = true;
 
-    // Clear all existing log files before starting (Just in case there are files with the exact name process)
-    for (const auto& screenEntry : screens) {
-        std::ofstream logFile(screenEntry.first + ".txt", std::ios::trunc);
+    // Delete all previous processes and clear their log files (Just in case there are files with the exact name process).
+    // Processes still queued or running are left to finish.
+    scheduler->getLogCache().closeAll();
+    std::unique_lock<ProfiledMutex> lock(screensMutex);
+    for (auto it = screens.begin(); it != screens.end();) {
+        if (!scheduler->removeProcess(it->second)) {
+            ++it;
+            continue;
+        }
+
+        const String& logPath = it->second.nameEntry->logPath;
+        std::ofstream logFile(logPath, std::ios::trunc);
         if (logFile.is_open()) {
             logFile.close();
         }
         else {
-            std::cerr << "Error: Could not clear file " << screenEntry.first << ".txt\n";
+            std::cerr << "Error: Could not clear file " << logPath << "\n";
         }
+        it = screens.erase(it);
     }
+    lock.unlock();
 
-    // Delete all previous processes
-    screens.clear();
-
-    std::thread processGeneratorThread([this]() {
+    generatorThread = std::thread([this]() {
         std::random_device rd;
         std::mt19937 gen(rd());
         std::uniform_int_distribution<> dist(config.min_ins, config.max_ins);
@@ -185,15 +768,29 @@ void ScreenManager::schedulerTest() {
         while (testRunning) {
             // Add a new process at intervals defined by batch_process_freq
             if (cycleCounter % (config.batch_process_freq * 40) == 0) {
-                String screenName = "process" + std::to_string((cycleCounter / config.batch_process_freq) / 40);
+                // Shards of a cluster name processes by their cluster-wide ID, so names stay unique
+                char screenName[32];
+                long long globalPid = cluster.isAttached() ? cluster.allocatePid() : -1;
+                if (globalPid >= 0) {
+                    snprintf(screenName, sizeof(screenName), "process%lld", globalPid);
+                }
+                else {
+                    snprintf(screenName, sizeof(screenName), "process%d", (cycleCounter / config.batch_process_freq) / 40);
+                }
                 int instructionCount = dist(gen);
 
                 // Create a new screen (process) and set its instruction count
-                screenCreate(screenName, "schedulerTest");
-                screens[screenName].totalLines = instructionCount;
+                Screen* screen = screenCreate(screenName, "schedulerTest", 0, globalPid);
+                if (screen) {
+                    screen->totalLines = instructionCount;
 
-                // Add the new process to the scheduler
-                scheduler->addProcess(screens[screenName]);
+                    // Add the new process to the scheduler, blocking here under the block policy
+                    if (scheduler->submitProcess(*screen, &testRunning) == Admission::Dropped) {
+                        scheduler->removeProcess(*screen);
+                        std::lock_guard<ProfiledMutex> lock(screensMutex);
+                        screens.erase(screen->pid);
+                    }
+                }
             }
 
             // Apply delay
@@ -204,15 +801,24 @@ void ScreenManager::schedulerTest() {
             cycleCounter++;
         }
      });
+}
 
-    // Detach the thread to let it run in the background
-    processGeneratorThread.detach();
+// Stops the scheduler-test generator and waits for it, so it never adds to a scheduler
+// that is being replaced
+void ScreenManager::stopGenerator() {
+    testRunning = false;
+    if (scheduler) {
+        scheduler->wakeCreators();  // a generator blocked on admission defers its process
+    }
+    if (generatorThread.joinable()) {
+        generatorThread.join();
+    }
 }
 
 void ScreenManager::schedulerStop() {
     if (testRunning) {
         // Stop the background scheduler loop
-        testRunning = false;
+        stopGenerator();
         printInColor("Scheduler-test stopped.\n\n", "yellow");
     }
     else {
@@ -220,6 +826,22 @@ void ScreenManager::schedulerStop() {
     }
 }
 
+// Reads a config value that may be wrapped in double quotes
+static String readConfigString(std::istream& file) {
+    String value;
+    file >> std::ws;
+
+    char firstChar = file.peek();
+    if (firstChar == '"') {
+        file.get();
+        std::getline(file, value, '"');
+    }
+    else {
+        file >> value;
+    }
+    return value;
+}
+
 void ScreenManager::loadConfig(const String& filename) {
     std::ifstream file(filename);
     if (!file.is_open()) {
@@ -235,19 +857,9 @@ void ScreenManager::loadConfig(const String& filename) {
             config.num_cpu = clamp(value, 1, 128);
         }
         else if (parameter == "scheduler") {
-            String schedulerValue;
-            file >> std::ws;
+            String schedulerValue = readConfigString(file);
 
-            char firstChar = file.peek();
-            if (firstChar == '"') {
-                file.get();
-                std::getline(file, schedulerValue, '"'); 
-            }
-            else {
-                file >> schedulerValue;
-            }
-
-            if (schedulerValue == "fcfs" || schedulerValue == "rr") {
+            if (schedulerValue == "fcfs" || schedulerValue == "rr" || schedulerValue == "cfs") {
                 config.scheduler = schedulerValue;
             }
             else {
@@ -279,23 +891,196 @@ void ScreenManager::loadConfig(const String& filename) {
             file >> value;
             config.delays_per_exec = clamp(value, 0, 4294967296); // [0, 2^32
         }
+        else if (parameter == "max-overall-mem") {
+            int value;
+            file >> value;
+            config.max_overall_mem = clamp(value, 0, 1 << 30); // [0, 2^30], 0 disables
+        }
+        else if (parameter == "mem-per-ins") {
+            int value;
+            file >> value;
+            config.mem_per_ins = clamp(value, 1, 1 << 20); // [1, 2^20]
+        }
+        else if (parameter == "memory-allocator") {
+            String allocatorValue = readConfigString(file);
+            AllocatorType type;
+
+            if (MemoryAllocator::parseType(allocatorValue, type)) {
+                config.memory_allocator = allocatorValue;
+            }
+            else {
+                throw std::runtime_error("Invalid memory-allocator value.");
+            }
+        }
+        else if (parameter == "memory-snapshot-quanta") {
+            int value;
+            file >> value;
+            config.memory_snapshot_quanta = clamp(value, 0, 4294967296); // [0, 2^32], 0 disables
+        }
+        else if (parameter == "ready-queue") {
+            String queueValue = readConfigString(file);
+
+            if (queueValue == "locked" || queueValue == "ring") {
+                config.ready_queue = queueValue;
+            }
+            else {
+                throw std::runtime_error("Invalid ready-queue value.");
+            }
+        }
+        else if (parameter == "ready-queue-capacity") {
+            int value;
+            file >> value;
+            config.ready_queue_capacity = clamp(value, 2, 1 << 24); // [2, 2^24]
+        }
+        else if (parameter == "log-cache-size") {
+            int value;
+            file >> value;
+            config.log_cache_size = clamp(value, 1, 65536); // [1, 2^16], at least num-cpu is used
+        }
+        else if (parameter == "dispatch-batch") {
+            int value;
+            file >> value;
+            config.dispatch_batch = clamp(value, 1, 1024); // [1, 1024]
+        }
+        else if (parameter == "min-granularity") {
+            int value;
+            file >> value;
+            config.min_granularity = clamp(value, 1, 1000); // [1, 1000] ticks
+        }
+        else if (parameter == "balance-interval") {
+            int value;
+            file >> value;
+            config.balance_interval = clamp(value, 1, 10000); // [1, 10000] ticks
+        }
+        else if (parameter == "core-affinity") {
+            String affinityValue = readConfigString(file);
+
+            if (affinityValue == "on" || affinityValue == "off") {
+                config.core_affinity = affinityValue == "on";
+            }
+            else {
+                throw std::runtime_error("Invalid core-affinity value.");
+            }
+        }
+        else if (parameter == "profile") {
+            String profileValue = readConfigString(file);
+
+            if (profileValue == "on" || profileValue == "off") {
+                config.profile = profileValue == "on";
+            }
+            else {
+                throw std::runtime_error("Invalid profile value.");
+            }
+        }
+        else if (parameter == "io-devices") {
+            int value;
+            file >> value;
+            config.io_devices = clamp(value, 0, 64); // [0, 64], 0 disables
+        }
+        else if (parameter == "io-interval") {
+            int value;
+            file >> value;
+            config.io_interval = clamp(value, 1, 1 << 20); // [1, 2^20] instructions
+        }
+        else if (parameter == "io-bound-percent") {
+            int value;
+            file >> value;
+            config.io_bound_percent = clamp(value, 0, 100); // [0, 100]
+        }
+        else if (parameter == "io-service-ms") {
+            int value;
+            file >> value;
+            config.io_service_ms = clamp(value, 0, 60000); // [0, 60000] ms
+        }
+        else if (parameter == "io-service-dist") {
+            String distValue = readConfigString(file);
+            ServiceDistribution distribution;
+
+            if (IoDevices::parseDistribution(distValue, distribution)) {
+                config.io_service_dist = distValue;
+            }
+            else {
+                throw std::runtime_error("Invalid io-service-dist value.");
+            }
+        }
+        else if (parameter == "migration-penalty") {
+            int value;
+            file >> value;
+            config.migration_penalty = clamp(value, 0, 1000); // [0, 1000] ticks
+        }
+        else if (parameter == "tick-ms") {
+            int value;
+            file >> value;
+            config.tick_ms = clamp(value, 1, 1000); // [1, 1000]
+        }
+        else if (parameter == "mailbox-slots") {
+            int value;
+            file >> value;
+            config.mailbox_slots = clamp(value, 1, 4096); // [1, 4096]
+        }
+        else if (parameter == "trace-buffer-events") {
+            int value;
+            file >> value;
+            config.trace_buffer_events = clamp(value, 0, 1 << 24); // [0, 2^24]
+        }
+        else if (parameter == "status-page-ticks") {
+            int value;
+            file >> value;
+            config.status_page_ticks = clamp(value, 0, 10000); // [0, 10000] ticks, 0 disables
+        }
+        else if (parameter == "cluster-shards") {
+            int value;
+            file >> value;
+            config.cluster_shards = clamp(value, 0, clusterMaxShards); // [0, 16], 0 runs standalone
+        }
+        else if (parameter == "cluster-balance-ticks") {
+            int value;
+            file >> value;
+            config.cluster_balance_ticks = clamp(value, 1, 10000); // [1, 10000] ticks
+        }
+        else if (parameter == "max-ready") {
+            int value;
+            file >> value;
+            config.max_ready = clamp(value, 0, 1 << 24); // [0, 2^24], 0 for no limit
+        }
+        else if (parameter == "max-live") {
+            int value;
+            file >> value;
+            config.max_live = clamp(value, 0, 1 << 24); // [0, 2^24], 0 for no limit
+        }
+        else if (parameter == "admission-policy") {
+            String policyValue = readConfigString(file);
+            AdmissionPolicy policy;
+
+            if (AdmissionControl::parsePolicy(policyValue, policy)) {
+                config.admission_policy = policyValue;
+            }
+            else {
+                throw std::runtime_error("Invalid admission-policy value.");
+            }
+        }
         else {
             std::cerr << "Unknown parameter in config file: " << parameter << std::endl;
         }
     }
 
     file.close();
+
+    if (config.max_overall_mem > 0 && config.max_overall_mem < (1 << BuddyAllocator::minOrder) && config.memory_allocator == "buddy") {
+        throw std::runtime_error("max-overall-mem must be at least " + std::to_string(1 << BuddyAllocator::minOrder) + " for the buddy allocator.");
+    }
 }
 
 void ScreenManager::initialize() {
 
     if (scheduler) {
         // Delete the previous scheduler and all previous processes
-        schedulerRunning = false;
-        scheduler->finish();
-        delete scheduler;
-        scheduler = nullptr;
+        stopGenerator();
+        scheduler->stop();
+        scheduler.reset();
+        cluster.detach();
         screens.clear();
+        reportedChange = 0;
     }
 
     try {
@@ -311,22 +1096,81 @@ void ScreenManager::initialize() {
     std::cout << "Number of CPUs: " << config.num_cpu << "\n";
     std::cout << "Scheduler: " << config.scheduler << "\n";
     std::cout << "Quantum Cycles: " << config.quantum_cycles << "\n";
+    if (config.scheduler == "cfs") {
+        std::cout << "Min Granularity: " << config.min_granularity << " ticks\n";
+    }
+    else {
+        std::cout << "Core Affinity: " << (config.core_affinity ? "on" : "off") << "\n";
+    }
+    std::cout << "Balance Interval: " << config.balance_interval << " ticks\n";
+    std::cout << "Migration Penalty: " << config.migration_penalty << " ticks\n";
     std::cout << "Batch Process Frequency: " << config.batch_process_freq << "\n";
     std::cout << "Minimum Instructions: " << config.min_ins << "\n";
     std::cout << "Maximum Instructions: " << config.max_ins << "\n";
     std::cout << "Delays per Exec: " << config.delays_per_exec << "\n";
+    std::cout << "Tick Period: " << config.tick_ms << " ms\n";
+    std::cout << "Dispatch Batch: " << config.dispatch_batch;
+    if (config.scheduler == "cfs" && config.dispatch_batch > 1) {
+        std::cout << " (cfs takes one process at a time)";
+    }
+    std::cout << "\n";
+    std::cout << "Log Cache Size: " << config.log_cache_size << "\n";
+    std::cout << "Mailbox Slots: " << config.mailbox_slots << "\n";
+    std::cout << "Ready Queue: " << config.ready_queue;
+    if (config.ready_queue == "ring") {
+        std::cout << " (" << config.ready_queue_capacity << " slots)";
+    }
+    std::cout << "\n";
+    if (config.trace_buffer_events > 0) {
+        std::cout << "Trace Buffer: " << config.trace_buffer_events << " events per core\n";
+    }
+    if (config.profile) {
+        std::cout << "Profiling: on (profile-dump)\n";
+    }
+    if (config.max_ready > 0 || config.max_live > 0) {
+        std::cout << "Max Ready: " << config.max_ready << "\n";
+        std::cout << "Max Live: " << config.max_live << "\n";
+        std::cout << "Admission Policy: " << config.admission_policy << "\n";
+    }
+    if (config.io_devices > 0) {
+        std::cout << "I/O Devices: " << config.io_devices << "\n";
+        std::cout << "I/O Interval: " << config.io_interval << " instructions\n";
+        std::cout << "I/O-Bound Processes: " << config.io_bound_percent << "%\n";
+        std::cout << "I/O Service Time: " << config.io_service_ms << " ms mean, " << config.io_service_dist << "\n";
+    }
+    if (config.max_overall_mem > 0) {
+        std::cout << "Max Overall Memory: " << config.max_overall_mem << "\n";
+        std::cout << "Memory per Instruction: " << config.mem_per_ins << "\n";
+        std::cout << "Memory Allocator: " << config.memory_allocator << "\n";
+        std::cout << "Memory Snapshot Quanta: " << config.memory_snapshot_quanta << "\n";
+    }
+    if (config.cluster_shards > 0) {
+        std::cout << "Cluster Shards: " << config.cluster_shards << "\n";
+    }
 
-    scheduler = new Scheduler(config);
-
-    // Start the scheduler thread
-    schedulerRunning = true;
-    schedulerThread = std::thread([this]() {
-        while (schedulerRunning) {
-            // Scheduler background tasks go here, if any
-            std::this_thread::sleep_for(std::chrono::milliseconds(100)); // Polling delay
+    Profiler::instance().reset(config.profile, config.num_cpu);
+    scheduler = Scheduler::create(config);
+    if (config.cluster_shards > 0) {
+        String error;
+        if (cluster.attach(config.cluster_shards, config.cluster_balance_ticks * config.tick_ms, error)) {
+            scheduler->addTickHook(config.cluster_balance_ticks, [this](long long tick) { balanceCluster(tick); });
+            std::cout << "Cluster: shard " << cluster.shardId() << " of " << cluster.shardCount() << " in "
+                << clusterRegionName << " (balanced every " << config.cluster_balance_ticks << " ticks)\n";
+        }
+        else {
+            printInColor("Cluster unavailable, running standalone: " + error + "\n", "yellow");
         }
-        });
+    }
+    scheduler->start();
+    if (config.status_page_ticks > 0 && config.cluster_shards == 0) {
+        if (scheduler->statusPageOpen()) {
+            std::cout << "Status Page: " << scheduler->publishedPageName() << " (every " << config.status_page_ticks << " ticks)\n";
+        }
+        else {
+            printInColor("Status page unavailable: could not create shared memory " + String(statusPageName)
+                + " or a page of this process\n", "yellow");
+        }
+    }
 
-    schedulerThread.detach();
     printInColor("Initialization complete.\n\n", "green");
 }
@@ -4,8 +4,19 @@
 #include "Utils.h"
 #include "Screen.h"
 #include "Scheduler.h"
+#include "ProcessIndex.h"
+#include "NameTable.h"
+#include "ClusterNode.h"
+#include "Pool.h"
+#include "Profiler.h"
 #include <unordered_map>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <ostream>
+#include <cstdint>
 
 class ConsoleManager;
 class Screen;
@@ -14,21 +25,51 @@ class Screen;
 class ScreenManager {
 private:
     ConsoleManager& consoleManager;             // reference to the console manager
-    Scheduler* scheduler;                            // pointer to Scheduler
+    std::unique_ptr<Scheduler> scheduler;            // scheduler built for the configured policy
+    ClusterNode cluster;                        // shard of a multi-process cluster, if cluster-shards is set
+    ProfiledMutex screensMutex{ LockSite::ProcessTable };   // screens is changed by the console, the generator and the cluster
+    NodePool processPool;                       // nodes of screens, recycled as processes come and go (guarded by screensMutex)
+
+    void balanceCluster(long long tick);        // publish, take in and send off migrated processes
+    void immigrate(const ClusterProcess& process);
 public:
-    std::unordered_map<String, Screen> screens; // list of screens
+    typedef std::unordered_map<int, Screen, std::hash<int>, std::equal_to<int>,
+        PoolAllocator<std::pair<const int, Screen>>> ScreenMap;
+
+    NameTable names;                            // interned process names
+    ScreenMap screens;                          // list of screens, keyed by pid
     String currentScreen;                  // current screen displayed
     ScreenManager(ConsoleManager& cm);
-    void screenCreate(const String& name, const String& type);     // create screen
+    ~ScreenManager();
+    Screen* screenCreate(const String& name, const String& type, int nice = 0, long long globalPid = -1);  // create screen
+    void screenCreateBatch(const String& args);     // create many processes at once
+    bool parseCreateOptions(const String& args, String& name, int& nice);   // parse screen -s options
+    Screen* findScreen(const String& name);    // screen by name, or null
+    const Screen* findScreen(const String& name, std::unique_lock<ProfiledMutex>& lock);  // same, left locked while read
     void screenRestore(const String& name);    // inspect screen
-    void screenList(const String& type);              // display screen list
+    void screenList(const String& type, const ProcessQuery& query = ProcessQuery()); // display screen list
+    void writeListing(std::ostream& output, const ProcessQuery& query);   // stream the listing
+    void reportChanges();                            // append processes changed since the last report
+    bool parseListOptions(const String& args, ProcessQuery& query);  // parse screen -ls options
     void schedulerTest();                            // Method to start the scheduler
     void schedulerStop();
+    void coreStat();                                 // print per-core idle/busy accounting
+    void memoryStat();                               // print emulated memory statistics
+    void ipcStat();                                  // print SEND/RECV throughput and blocking
+    void admissionStat();                            // print admission waits and rejections
+    void allocStat();                                // print heap allocations and pool use
+    void profileDump();                              // print lock and log I/O timings of the profiling mode
+    void ipcTest(const String& args);                // create communicating process pairs
+    void traceExport(const String& filename);        // write recorded events as Chrome trace JSON
     void initialize();
     void loadConfig(const String& filename);
     std::atomic<bool> testRunning{ false };
-    std::atomic<bool> schedulerRunning{ false };
-    std::thread schedulerThread;
+    std::thread generatorThread;                // scheduler-test process generator
+    void stopGenerator();
+    void shutdown();                            // stop the generator and the scheduler
+    int pipeCount = 0;                          // pipe pairs created so far, for naming
+    uint64_t reportedChange = 0;                // index change sequence covered by the last report
+    int reportCount = 0;                        // appended reports so far, for numbering
 };
 
 #endif // SCREENMANAGER_H
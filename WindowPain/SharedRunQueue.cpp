@@ -0,0 +1,181 @@
+#include "SharedRunQueue.h"
+#include "Screen.h"
+#include "Utils.h"
+
+#include <limits>
+#include <algorithm>
+
+SharedRunQueue::SharedRunQueue(const Config& config)
+    : queue(ReadyQueue::create(config)), sharers(static_cast<size_t>(config.num_cpu)),
+    affinity(config.core_affinity), coldNs(static_cast<long long>(config.migration_penalty) * config.tick_ms * 1000000),
+    origin(std::chrono::steady_clock::now()) {
+    if (affinity) {
+        for (int i = 0; i < config.num_cpu; ++i) {
+            cores.emplace_back(new CoreQueue());
+        }
+    }
+}
+
+long long SharedRunQueue::nowNs() const {
+    return elapsedNs(origin);
+}
+
+int SharedRunQueue::shortest() const {
+    int best = 0;
+    for (int i = 1; i < static_cast<int>(cores.size()); ++i) {
+        if (cores[i]->size < cores[best]->size) best = i;
+    }
+    return best;
+}
+
+int SharedRunQueue::longest() const {
+    int best = 0;
+    for (int i = 1; i < static_cast<int>(cores.size()); ++i) {
+        if (cores[i]->size > cores[best]->size) best = i;
+    }
+    return best;
+}
+
+// A process that never ran has nothing cached anywhere, so it counts as cold from the start
+bool SharedRunQueue::push(Screen* screen) {
+    if (!affinity) return queue->push(screen);
+
+    bool ran = screen->lastCoreId >= 0 && screen->lastCoreId < static_cast<int>(cores.size());
+    int coreId = ran ? screen->lastCoreId : shortest();
+    CoreQueue& core = *cores[coreId];
+
+    std::lock_guard<ProfiledMutex> lock(core.mutex);
+    locks++;
+    screen->coreId = coreId;
+    core.waiting.push_back({ screen, ran ? nowNs() : std::numeric_limits<long long>::min() });
+    core.size++;
+    return true;
+}
+
+void SharedRunQueue::pushOverflow(Screen* screen) {
+    if (!affinity) return queue->pushOverflow(screen);
+    push(screen);   // the core queues are unbounded
+}
+
+// Deals a batch of new processes out over the core queues, starting with the shortest
+size_t SharedRunQueue::pushNew(Screen* const* screens, size_t count) {
+    if (!affinity) return queue->pushBatch(screens, count);
+
+    dealRuns(count, cores.size(), shortest(), [&](int coreId, size_t begin, size_t end) {
+        CoreQueue& core = *cores[coreId];
+        std::lock_guard<ProfiledMutex> lock(core.mutex);
+        locks++;
+        for (size_t i = begin; i < end; ++i) {
+            screens[i]->coreId = coreId;
+            core.waiting.push_back({ screens[i], std::numeric_limits<long long>::min() });
+        }
+        core.size += end - begin;
+    });
+    return count;
+}
+
+// Caller holds core.mutex. Takes from the front while the processes waited since before coldBefore.
+size_t SharedRunQueue::take(CoreQueue& core, Screen** out, size_t maxCount, long long coldBefore) {
+    size_t count = 0;
+    while (count < maxCount && !core.waiting.empty() && core.waiting.front().sinceNs <= coldBefore) {
+        out[count++] = core.waiting.front().screen;
+        core.waiting.pop_front();
+        core.size--;
+    }
+    return count;
+}
+
+// Takes the processes that have waited longest in the fullest other core queue, as long
+// as they have gone cold
+size_t SharedRunQueue::steal(int coreId, Screen** out, size_t maxCount) {
+    int victim = -1;
+    for (int i = 0; i < static_cast<int>(cores.size()); ++i) {
+        if (i != coreId && cores[i]->size > 0 && (victim < 0 || cores[i]->size > cores[victim]->size)) {
+            victim = i;
+        }
+    }
+    if (victim < 0) return 0;
+
+    CoreQueue& core = *cores[victim];
+    std::lock_guard<ProfiledMutex> lock(core.mutex);
+    locks++;
+    size_t count = take(core, out, maxCount, nowNs() - coldNs);
+    migrations += count;
+    return count;
+}
+
+// A core runs its own queue in arrival order and steals only when it is empty
+size_t SharedRunQueue::popBatch(int coreId, Screen** out, size_t maxCount) {
+    if (!affinity) return queue->popBatch(out, maxCount, sharers);
+
+    CoreQueue& core = *cores[coreId];
+    if (core.size > 0) {
+        std::lock_guard<ProfiledMutex> lock(core.mutex);
+        locks++;
+        size_t count = take(core, out, maxCount, std::numeric_limits<long long>::max());
+        if (count > 0) return count;
+    }
+    return steal(coreId, out, maxCount);
+}
+
+size_t SharedRunQueue::pushBatch(int coreId, Screen* const* screens, size_t count) {
+    if (!affinity) return queue->pushBatch(screens, count);
+
+    CoreQueue& core = *cores[coreId];
+    std::lock_guard<ProfiledMutex> lock(core.mutex);
+    locks++;
+    long long now = nowNs();
+    for (size_t i = 0; i < count; ++i) {
+        core.waiting.push_back({ screens[i], now });
+    }
+    core.size += count;
+    return count;
+}
+
+// Gives up the processes at the back of the fullest core queues, the ones that would wait
+// longest here. The shared queue only gives up its front.
+size_t SharedRunQueue::shed(Screen** out, size_t maxCount) {
+    if (!affinity) return queue->popBatch(out, maxCount, 1);
+
+    size_t count = 0;
+    while (count < maxCount) {
+        CoreQueue& core = *cores[longest()];
+        if (core.size == 0) break;
+
+        std::lock_guard<ProfiledMutex> lock(core.mutex);
+        locks++;
+        if (core.waiting.empty()) continue;
+        out[count++] = core.waiting.back().screen;
+        core.waiting.pop_back();
+        core.size--;
+    }
+    return count;
+}
+
+// An idle core only looks at other cores' queues when it is woken, so a process that
+// goes cold while its core is busy gets an idle core woken for it here
+void SharedRunQueue::balance(const std::function<void(int)>& wake) {
+    if (!affinity) return;
+
+    long long coldBefore = nowNs() - coldNs;
+    for (auto& core : cores) {
+        if (core->size == 0) continue;
+
+        bool cold;
+        {
+            std::lock_guard<ProfiledMutex> lock(core->mutex);
+            locks++;
+            cold = !core->waiting.empty() && core->waiting.front().sinceNs <= coldBefore;
+        }
+        if (cold) wake(-1);
+    }
+}
+
+bool SharedRunQueue::empty(int coreId) const {
+    if (!affinity) return queue->size() == 0;
+    return cores[coreId]->size == 0;
+}
+
+long long SharedRunQueue::lockCount() const {
+    return affinity ? locks.load() : queue->lockCount();
+}
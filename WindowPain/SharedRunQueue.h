@@ -0,0 +1,68 @@
+#ifndef SHAREDRUNQUEUE_H
+#define SHAREDRUNQUEUE_H
+
+#include "Config.h"
+#include "ReadyQueue.h"
+#include "Pool.h"
+#include "Profiler.h"
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+class Screen;
+
+// Run queue of the fcfs and rr policies. With core-affinity off it is the configured
+// ReadyQueue (locked or ring), split evenly between the cores when they take batches.
+// With core-affinity on, every core has its own FIFO queue: a process waits on the core
+// it last ran on (new processes on the shortest queue), and another core only takes it
+// once it has waited migration-penalty ticks, the time a migration would cost it anyway.
+class SharedRunQueue {
+private:
+    struct Waiting {
+        Screen* screen;
+        long long sinceNs;
+    };
+
+    struct CoreQueue {
+        ProfiledMutex mutex{ LockSite::CoreQueue };
+        NodePool blocks;                    // deque blocks, reused as the queue cycles
+        std::deque<Waiting, PoolAllocator<Waiting>> waiting;
+        std::atomic<size_t> size{ 0 };
+
+        CoreQueue() : waiting(PoolAllocator<Waiting>(&blocks)) {}
+    };
+
+    std::unique_ptr<ReadyQueue> queue;          // used without affinity
+    std::vector<std::unique_ptr<CoreQueue>> cores;
+    size_t sharers;
+    bool affinity;
+    long long coldNs;                           // wait after which a process may be taken by any core
+    std::chrono::steady_clock::time_point origin;
+    mutable std::atomic<long long> locks{ 0 };
+    std::atomic<long long> migrations{ 0 };
+
+    long long nowNs() const;
+    size_t take(CoreQueue& core, Screen** out, size_t maxCount, long long coldBefore);
+    int shortest() const;
+    int longest() const;
+    size_t steal(int coreId, Screen** out, size_t maxCount);
+
+public:
+    explicit SharedRunQueue(const Config& config);
+    bool push(Screen* screen);                          // new or woken process
+    void pushOverflow(Screen* screen);                  // same, past a full ring; for the cores
+    size_t pushNew(Screen* const* screens, size_t count);   // new processes, spread over the cores; how many fit
+    size_t popBatch(int coreId, Screen** out, size_t maxCount);
+    size_t pushBatch(int coreId, Screen* const* screens, size_t count);  // preempted processes
+    size_t shed(Screen** out, size_t maxCount);         // processes leaving for another shard
+    bool empty(int coreId) const;                       // nothing waiting for this core
+    void balance(const std::function<void(int)>& wake); // wake idle cores for cold processes
+    long long lockCount() const;
+    long long migrationCount() const { return migrations; }
+};
+
+#endif // SHAREDRUNQUEUE_H
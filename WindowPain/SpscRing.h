@@ -0,0 +1,66 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+// Bounded lock-free single-producer/single-consumer ring buffer. Slots are handed out
+// by reference: the producer fills a claimed slot in place and publishes it, the
+// consumer reads the front slot in place and then consumes it, so a message is never
+// copied through the ring.
+template <typename T>
+class SpscRing {
+private:
+    // Keep the consumer and producer positions on separate cache lines
+    alignas(64) std::atomic<size_t> head{ 0 };   // next slot to read
+    alignas(64) std::atomic<size_t> tail{ 0 };   // next slot to write
+    alignas(64) std::vector<T> slots;
+    size_t mask;
+
+    static size_t roundUp(size_t n) {
+        size_t size = 1;
+        while (size < n) size <<= 1;
+        return size;
+    }
+
+public:
+    explicit SpscRing(size_t capacity) : slots(roundUp(capacity)), mask(slots.size() - 1) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer: slot to fill, or null if the ring is full
+    T* claim() {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        if (pos - head.load(std::memory_order_acquire) == slots.size()) return nullptr;
+        return &slots[pos & mask];
+    }
+
+    // Producer: makes the claimed slot visible to the consumer
+    void publish() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Consumer: oldest published slot, or null if the ring is empty
+    const T* front() const {
+        size_t pos = head.load(std::memory_order_relaxed);
+        if (pos == tail.load(std::memory_order_acquire)) return nullptr;
+        return &slots[pos & mask];
+    }
+
+    // Consumer: hands the front slot back to the producer
+    void consume() {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const {
+        return slots.size();
+    }
+};
+
+#endif // SPSCRING_H
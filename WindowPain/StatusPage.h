@@ -0,0 +1,107 @@
+#ifndef STATUSPAGE_H
+#define STATUSPAGE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+
+// Layout of the shared-memory status page the scheduler publishes for external monitors
+// (see StatusPublisher and the StatusReader tool). Plain fixed-size fields only, so the
+// page reads the same from any process built from this header.
+//
+// The page is a seqlock: the scheduler makes sequence odd, rewrites the snapshot and makes
+// it even again. Readers copy the snapshot and retry if the sequence was odd or changed,
+// so they never block the scheduler and any number of them can poll.
+
+#ifdef _WIN32
+static const char* const statusPageName = "Local\\WindowPainStatus";
+#else
+static const char* const statusPageName = "/windowpain-status";
+#endif
+
+// Page of the emulator with the given process ID, used when another emulator on the host
+// already holds statusPageName
+static inline void statusPageNameFor(long long pid, char* out, size_t size) {
+    snprintf(out, size, "%s-%lld", statusPageName, pid);
+}
+
+static const uint32_t statusPageMagic = 0x54535057;    // "WPST"
+static const uint32_t statusPageVersion = 1;            // bumped whenever the layout changes
+static const int statusMaxCores = 128;
+static const int statusTopProcesses = 16;
+static const int statusNameLength = 32;
+
+struct StatusCore {
+    int32_t busy;                       // 1 while running a process
+    char process[statusNameLength];     // name of the running process, empty if none
+    int64_t busyTicks;
+    int64_t idleTicks;
+    int64_t wakeups;
+    int64_t migrationsIn;
+    int64_t migrationsOut;
+};
+
+struct StatusProcess {
+    char name[statusNameLength];
+    int32_t state;                      // ProcessState: 0 new, 1 ready, 2 running, 3 finished, 4 blocked
+    int32_t coreId;
+    int32_t currentLine;
+    int32_t totalLines;
+};
+
+struct StatusSnapshot {
+    int64_t publishedMs;                // wall clock, ms since the Unix epoch
+    int64_t tick;
+    int64_t tickMs;
+    char policy[8];
+    int32_t numCores;                   // entries used in cores
+    int32_t activeCores;
+
+    int64_t instructions;
+    int64_t dispatches;
+    int64_t migrations;
+    int64_t queueLocks;
+
+    int64_t ready;                      // queue depths and process counts
+    int64_t running;
+    int64_t blocked;
+    int64_t finished;
+    int64_t waitingForMemory;           // admitted, not placed in memory yet
+    int64_t live;                       // admitted and unfinished
+    int64_t pendingAdmission;
+
+    int32_t topCount;                   // entries used in top: running first, then ready, by progress
+    int32_t reserved;
+    StatusCore cores[statusMaxCores];
+    StatusProcess top[statusTopProcesses];
+};
+
+struct StatusPage {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;                      // sizeof(StatusPage) of the writer
+    uint32_t reserved;
+    std::atomic<uint64_t> sequence;     // odd while the snapshot is being rewritten
+    StatusSnapshot snapshot;
+};
+
+// Copies a consistent snapshot out of a seqlocked slot. Returns false if the writer kept
+// it busy for every attempt.
+inline bool readSnapshot(const std::atomic<uint64_t>& sequence, const StatusSnapshot& snapshot,
+    StatusSnapshot& out, int attempts = 1000) {
+    for (int i = 0; i < attempts; ++i) {
+        uint64_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        std::memcpy(&out, &snapshot, sizeof(out));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == before) return true;
+    }
+    return false;
+}
+
+inline bool readStatusPage(const StatusPage& page, StatusSnapshot& out, int attempts = 1000) {
+    return readSnapshot(page.sequence, page.snapshot, out, attempts);
+}
+
+#endif // STATUSPAGE_H
@@ -0,0 +1,106 @@
+#include "StatusPublisher.h"
+
+#include <new>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+StatusPublisher::~StatusPublisher() {
+    close();
+}
+
+// Creates and maps a page that must not exist yet, so two emulators never write one page
+void* StatusPublisher::create(const char* name) {
+#ifdef _WIN32
+    HANDLE handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0,
+        static_cast<DWORD>(sizeof(StatusPage)), name);
+    if (!handle) return nullptr;
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        CloseHandle(handle);
+        return nullptr;
+    }
+
+    void* memory = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(StatusPage));
+    if (!memory) {
+        CloseHandle(handle);
+        return nullptr;
+    }
+    mapping = handle;
+#else
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) return nullptr;
+
+    void* memory = MAP_FAILED;
+    if (ftruncate(fd, sizeof(StatusPage)) == 0) {
+        memory = mmap(nullptr, sizeof(StatusPage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        shm_unlink(name);
+        return nullptr;
+    }
+#endif
+    snprintf(pageName, sizeof(pageName), "%s", name);
+    return memory;
+}
+
+bool StatusPublisher::open() {
+    close();
+
+    void* memory = create(statusPageName);
+    if (!memory) {
+        char fallback[sizeof(pageName)];
+#ifdef _WIN32
+        statusPageNameFor(GetCurrentProcessId(), fallback, sizeof(fallback));
+#else
+        statusPageNameFor(getpid(), fallback, sizeof(fallback));
+#endif
+        memory = create(fallback);
+        if (!memory) return false;
+    }
+
+    // Readers ignore the page until the magic and version are in place
+    page = new (memory) StatusPage();
+    page->size = sizeof(StatusPage);
+    page->version = statusPageVersion;
+    page->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    page->magic = statusPageMagic;
+    return true;
+}
+
+// Marks the page stale for readers that keep it mapped, then unmaps it
+void StatusPublisher::close() {
+    if (!page) return;
+
+    page->magic = 0;
+#ifdef _WIN32
+    UnmapViewOfFile(page);
+    CloseHandle(static_cast<HANDLE>(mapping));
+    mapping = nullptr;
+#else
+    munmap(page, sizeof(StatusPage));
+    shm_unlink(pageName);
+#endif
+    page = nullptr;
+    pageName[0] = '\0';
+}
+
+StatusSnapshot& StatusPublisher::beginWrite() {
+    uint64_t sequence = page->sequence.load(std::memory_order_relaxed);
+    page->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return page->snapshot;
+}
+
+void StatusPublisher::endWrite() {
+    page->sequence.store(page->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
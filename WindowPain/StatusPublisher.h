@@ -0,0 +1,34 @@
+#ifndef STATUSPUBLISHER_H
+#define STATUSPUBLISHER_H
+
+#include "StatusPage.h"
+
+// Owns the shared-memory status page and rewrites it under the seqlock. Only the tick
+// thread publishes, so there is a single writer: the page is only ever created, never
+// taken over, and an emulator that finds statusPageName in use publishes under a name
+// with its process ID instead.
+class StatusPublisher {
+private:
+    StatusPage* page = nullptr;
+    char pageName[64] = "";             // of the page this instance created
+#ifdef _WIN32
+    void* mapping = nullptr;            // HANDLE of the file mapping
+#endif
+
+    void* create(const char* name);     // map a new page, null if the name is taken
+
+public:
+    StatusPublisher() = default;
+    ~StatusPublisher();
+    StatusPublisher(const StatusPublisher&) = delete;
+    StatusPublisher& operator=(const StatusPublisher&) = delete;
+
+    bool open();                        // create the page; false if shared memory is unavailable
+    void close();                       // also removes the page, which only this instance writes
+    bool isOpen() const { return page != nullptr; }
+    const char* name() const { return pageName; }
+    StatusSnapshot& beginWrite();       // sequence odd; fill in the returned snapshot
+    void endWrite();                    // sequence even again
+};
+
+#endif // STATUSPUBLISHER_H
@@ -0,0 +1,152 @@
+#include "Tracer.h"
+
+#include <fstream>
+#include <algorithm>
+#include <cstdio>
+
+TraceBuffer::TraceBuffer(size_t capacity) : events(new TraceEvent[capacity]), capacity(capacity) {}
+
+void TraceBuffer::record(long long ns, const NameEntry* process, int coreId, TraceType type) {
+    size_t slot = reserved.fetch_add(1, std::memory_order_relaxed);
+    if (slot >= capacity) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    TraceEvent& event = events[slot];
+    event.ns = ns;
+    event.process = process;
+    event.coreId = coreId;
+    event.type = type;
+    event.committed.store(true, std::memory_order_release);
+}
+
+// Visits the events published so far; slots still being written are skipped
+template <typename Visit>
+void TraceBuffer::forEach(Visit visit) const {
+    size_t count = std::min(reserved.load(std::memory_order_relaxed), capacity);
+    for (size_t i = 0; i < count; ++i) {
+        if (events[i].committed.load(std::memory_order_acquire)) {
+            visit(events[i]);
+        }
+    }
+}
+
+size_t TraceBuffer::size() const {
+    return std::min(reserved.load(std::memory_order_relaxed), capacity);
+}
+
+Tracer::Tracer(int numCores, size_t eventsPerBuffer)
+    : origin(std::chrono::steady_clock::now()), numCores(numCores), enabled(eventsPerBuffer > 0) {
+    if (!enabled) return;
+    for (int i = 0; i <= numCores; ++i) {
+        buffers.emplace_back(new TraceBuffer(eventsPerBuffer));
+    }
+}
+
+void Tracer::recordEvent(TraceType type, const NameEntry* process, int coreId) {
+    long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - origin).count();
+    TraceBuffer& buffer = *buffers[coreId >= 0 && coreId < numCores ? coreId : numCores];
+    buffer.record(ns, process, coreId, type);
+}
+
+size_t Tracer::eventCount() const {
+    size_t total = 0;
+    for (const auto& buffer : buffers) total += buffer->size();
+    return total;
+}
+
+long long Tracer::droppedCount() const {
+    long long total = 0;
+    for (const auto& buffer : buffers) total += buffer->droppedCount();
+    return total;
+}
+
+static const char* traceTypeName(TraceType type) {
+    switch (type) {
+    case TraceType::Dispatch: return "dispatch";
+    case TraceType::Preempt: return "preempt";
+    case TraceType::Requeue: return "requeue";
+    case TraceType::Block: return "block";
+    case TraceType::Ready: return "ready";
+    case TraceType::Finish: return "finish";
+    }
+    return "unknown";
+}
+
+static void writeJsonString(std::ostream& out, const String& value) {
+    out << '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out << escaped;
+        }
+        else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+// Each core is a thread track: dispatch opens a slice named after the process and the
+// next preempt, block or finish on that core closes it. Requeue, ready and off-core
+// block events are instants on their core's track or on the "Scheduler" track.
+bool Tracer::exportJson(const String& path) const {
+    std::vector<const TraceEvent*> events;
+    events.reserve(eventCount());
+    for (const auto& buffer : buffers) {
+        buffer->forEach([&](const TraceEvent& event) { events.push_back(&event); });
+    }
+    std::stable_sort(events.begin(), events.end(), [](const TraceEvent* a, const TraceEvent* b) {
+        return a->ns < b->ns;
+    });
+
+    std::ofstream file(path);
+    if (!file.is_open()) return false;
+
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"WindowPain\"}}";
+    for (int core = 0; core <= numCores; ++core) {
+        file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << core << ",\"args\":{\"name\":\"";
+        if (core < numCores) file << "Core " << core;
+        else file << "Scheduler";
+        file << "\"}}";
+        file << ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << core
+            << ",\"args\":{\"sort_index\":" << core << "}}";
+    }
+
+    std::vector<bool> open(numCores, false);
+    char ts[32];
+    for (const TraceEvent* event : events) {
+        int tid = event->coreId >= 0 && event->coreId < numCores ? event->coreId : numCores;
+        snprintf(ts, sizeof(ts), "%lld.%03lld", event->ns / 1000, event->ns % 1000);
+
+        const char* phase = "i";
+        if (tid < numCores && event->type == TraceType::Dispatch) {
+            phase = "B";
+            open[tid] = true;
+        }
+        else if (tid < numCores && open[tid] && (event->type == TraceType::Preempt ||
+            event->type == TraceType::Block || event->type == TraceType::Finish)) {
+            // Close the slice, then mark why it ended
+            file << ",\n{\"ph\":\"E\",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << ts << "}";
+            open[tid] = false;
+        }
+
+        file << ",\n{\"name\":";
+        writeJsonString(file, event->process ? event->process->name : String("?"));
+        file << ",\"cat\":\"" << traceTypeName(event->type) << "\",\"ph\":\"" << phase
+            << "\",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << ts;
+        if (phase[0] == 'i') file << ",\"s\":\"t\"";
+        file << ",\"args\":{\"event\":\"" << traceTypeName(event->type) << "\"";
+        if (event->process) file << ",\"pid\":" << event->process->pid;
+        file << "}}";
+    }
+
+    file << "\n]}\n";
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include "Utils.h"
+#include "NameTable.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+enum class TraceType : uint8_t { Dispatch, Preempt, Requeue, Block, Ready, Finish };
+
+struct TraceEvent {
+    long long ns;                   // since the tracer was created
+    const NameEntry* process;
+    int coreId;                     // -1 for events recorded off the cores
+    TraceType type;
+    std::atomic<bool> committed{ false };
+};
+
+// Fixed-size event buffer. Writers reserve a slot with one fetch_add and publish it
+// through the slot's committed flag, so recording never takes a lock; events past
+// the capacity are dropped and counted.
+class TraceBuffer {
+private:
+    std::unique_ptr<TraceEvent[]> events;
+    size_t capacity;
+    std::atomic<size_t> reserved{ 0 };
+    std::atomic<long long> dropped{ 0 };
+
+public:
+    explicit TraceBuffer(size_t capacity);
+    void record(long long ns, const NameEntry* process, int coreId, TraceType type);
+    template <typename Visit> void forEach(Visit visit) const;
+    size_t size() const;
+    long long droppedCount() const { return dropped; }
+};
+
+// Scheduling event recorder with one buffer per core plus one shared by the other
+// threads, exported as Chrome trace-event JSON (loads in Perfetto / chrome://tracing).
+class Tracer {
+private:
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+    std::chrono::steady_clock::time_point origin;
+    int numCores;
+    bool enabled;
+
+public:
+    Tracer(int numCores, size_t eventsPerBuffer);   // 0 events disables tracing
+    bool isEnabled() const { return enabled; }
+    void record(TraceType type, const NameEntry* process, int coreId) {
+        if (enabled) recordEvent(type, process, coreId);
+    }
+    void recordEvent(TraceType type, const NameEntry* process, int coreId);
+    size_t eventCount() const;
+    long long droppedCount() const;
+    bool exportJson(const String& path) const;
+};
+
+#endif // TRACER_H
@@ -2,9 +2,32 @@
 #define UTILS_H
 
 #include <string>
+#include <cstddef>
+#include <chrono>
+#include <algorithm>
 
 typedef std::string String;
 
 void printInColor(const String& text, const String& color);
 
+inline long long elapsedNs(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - since).count();
+}
+
+// Deals count items out over queues in equal runs, starting at queue first and going
+// round, so each queue takes one run and is locked once. pushRun(queueId, begin, end)
+// gets the index range of its run.
+template <typename PushRun>
+void dealRuns(size_t count, size_t queues, int first, PushRun pushRun) {
+    size_t share = (count + queues - 1) / queues;
+    int queueId = first;
+    size_t pushed = 0;
+    while (pushed < count) {
+        size_t run = std::min(share, count - pushed);
+        pushRun(queueId, pushed, pushed + run);
+        pushed += run;
+        queueId = (queueId + 1) % static_cast<int>(queues);
+    }
+}
+
 #endif // UTILS_H
\ No newline at end of file
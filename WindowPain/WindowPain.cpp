@@ -47,6 +47,15 @@ void commandLoop(ConsoleManager& console) {
                 printInColor("scheduler-test\n", "red");
                 printInColor("scheduler-stop\n", "red");
                 printInColor("report-util\n", "red");
+                printInColor("core-stat\n", "red");
+                printInColor("memory-stat\n", "red");
+                printInColor("ipc-test\n", "red");
+                printInColor("ipc-stat\n", "red");
+                printInColor("admission-stat\n", "red");
+                printInColor("alloc-stat\n", "red");
+                printInColor("profile-dump\n", "red");
+                printInColor("trace-export\n", "red");
+                printInColor("benchmark\n", "red");
                 std::cout << "\n";
             }
             else {